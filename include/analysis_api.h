@@ -9,14 +9,19 @@
 class AnalysisApi {
 public:
     static std::string generate_analysis_json(const Board& board);
+    // Takes M_total from the cache when the position was evaluated before
+    static std::string generate_analysis_json(const Board& board, EvalCache& cache);
     
 private:
     static std::string square_to_string(Square square);
     static std::string piece_to_string(Piece piece, Square square);
+    // Square names of every set bit, a1 first
+    static nlohmann::json squares_to_json(uint64_t squares);
     static float calculate_multivector_magnitude(const Multivector2D& mv);
     static float calculate_square_control_value(Square square, const Multivector2D& m_total);
     static nlohmann::json generate_heatmap(const Multivector2D& m_total);
     static nlohmann::json generate_bivectors(const Board& board);
+    static std::string build_analysis_json(const Board& board, const Multivector2D& M_total);
 };
 
 #endif // ANALYSIS_API_H 
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+// Occupancy-independent attack tables, built at compile time so they need no init call
+struct AttackTables {
+    uint64_t knight[64];
+    uint64_t king[64];
+    uint64_t pawn[2][64];        // [0] white, [1] black
+    uint64_t between[64][64];    // squares strictly between two aligned squares
+    uint64_t line[64][64];       // whole rank/file/diagonal through two aligned squares
+};
+
+constexpr uint64_t step_attacks(int square, const int (&offsets)[8][2], int count) {
+    uint64_t attacks = 0;
+    int rank = square / 8;
+    int file = square % 8;
+    
+    for (int i = 0; i < count; i++) {
+        int new_rank = rank + offsets[i][0];
+        int new_file = file + offsets[i][1];
+        
+        if (new_rank >= 0 && new_rank < 8 && new_file >= 0 && new_file < 8) {
+            attacks |= 1ULL << (new_rank * 8 + new_file);
+        }
+    }
+    
+    return attacks;
+}
+
+constexpr AttackTables make_attack_tables() {
+    AttackTables tables{};
+    
+    const int knight_offsets[8][2] = {
+        {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
+        {1, -2}, {1, 2}, {2, -1}, {2, 1}
+    };
+    const int king_offsets[8][2] = {
+        {-1, -1}, {-1, 0}, {-1, 1},
+        {0, -1}, {0, 1},
+        {1, -1}, {1, 0}, {1, 1}
+    };
+    const int white_pawn_offsets[8][2] = {{1, -1}, {1, 1}};
+    const int black_pawn_offsets[8][2] = {{-1, -1}, {-1, 1}};
+    
+    // Opposite directions are adjacent so a line is the union of rays 2k and 2k+1
+    const int directions[8][2] = {
+        {0, 1}, {0, -1}, {1, 0}, {-1, 0},
+        {1, 1}, {-1, -1}, {1, -1}, {-1, 1}
+    };
+    
+    for (int square = 0; square < 64; square++) {
+        tables.knight[square] = step_attacks(square, knight_offsets, 8);
+        tables.king[square] = step_attacks(square, king_offsets, 8);
+        tables.pawn[0][square] = step_attacks(square, white_pawn_offsets, 2);
+        tables.pawn[1][square] = step_attacks(square, black_pawn_offsets, 2);
+        
+        uint64_t rays[8] = {};
+        for (int d = 0; d < 8; d++) {
+            int rank = square / 8 + directions[d][0];
+            int file = square % 8 + directions[d][1];
+            while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                rays[d] |= 1ULL << (rank * 8 + file);
+                rank += directions[d][0];
+                file += directions[d][1];
+            }
+        }
+        
+        for (int d = 0; d < 8; d++) {
+            uint64_t line = rays[d & ~1] | rays[d | 1] | (1ULL << square);
+            uint64_t between = 0;
+            int rank = square / 8 + directions[d][0];
+            int file = square % 8 + directions[d][1];
+            
+            while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+                int target = rank * 8 + file;
+                tables.between[square][target] = between;
+                tables.line[square][target] = line;
+                between |= 1ULL << target;
+                rank += directions[d][0];
+                file += directions[d][1];
+            }
+        }
+    }
+    
+    return tables;
+}
+
+inline constexpr AttackTables ATTACK_TABLES = make_attack_tables();
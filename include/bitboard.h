@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
+#include <optional>
 #include <string>
-#include <vector>
+#include <string_view>
+#include "attack_tables.h"
 
 enum Square {
     A1, B1, C1, D1, E1, F1, G1, H1,
@@ -15,9 +18,23 @@ enum Square {
     A8, B8, C8, D8, E8, F8, G8, H8
 };
 
-enum Piece {
+enum Piece : uint8_t {
     WP, WN, WB, WR, WQ, WK,
-    BP, BN, BB, BR, BQ, BK
+    BP, BN, BB, BR, BQ, BK,
+    NO_PIECE
+};
+
+// Indexes per-colour tables such as pawn_attacks
+enum Color {
+    WHITE,
+    BLACK
+};
+
+// Which slice of the legal moves a generator emits; promotions go with the captures
+enum GenType {
+    CAPTURES,
+    QUIETS,
+    ALL_MOVES
 };
 
 enum MoveType {
@@ -29,17 +46,93 @@ enum MoveType {
     PROMOTION
 };
 
+// Packed into 16 bits: from (0-5), to (6-11), flags (12-15).
+// Flags 0-4 are the non-promotion MoveTypes; 8-11 are promotions to N, B, R, Q.
 struct Move {
-    Square from;
-    Square to;
-    MoveType type;
-    Piece promotion_piece;
+    uint16_t data;
+    
+    Move() : data(0) {}
+    Move(Square f, Square t, MoveType mt = NORMAL, Piece promo = WP)
+        : data(static_cast<uint16_t>(f | (t << 6) | (encode_flags(mt, promo) << 12))) {}
+    
+    Square from() const { return static_cast<Square>(data & 0x3F); }
+    Square to() const { return static_cast<Square>((data >> 6) & 0x3F); }
+    MoveType type() const { return (data & 0x8000) ? PROMOTION : static_cast<MoveType>(data >> 12); }
+    
+    // Colour follows from the origin rank: only white pawns promote from the seventh
+    Piece promotion_piece() const {
+        int base = (from() >> 3) == 6 ? WN : BN;
+        return static_cast<Piece>(base + ((data >> 12) & 3));
+    }
+    
+    bool operator==(const Move& other) const { return data == other.data; }
+    bool operator!=(const Move& other) const { return data != other.data; }
+
+private:
+    static int encode_flags(MoveType mt, Piece promo) {
+        return mt == PROMOTION ? 8 | (promo % 6 - 1) : mt;
+    }
+};
+
+// Fixed-capacity inline buffer; no position has more than 218 legal moves
+class MoveList {
+public:
+    static constexpr int MAX_MOVES = 256;
+    
+    MoveList() : count(0) {}
+    
+    void push_back(const Move& move) { moves[count++] = move; }
+    void clear() { count = 0; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
     
-    Move(Square f, Square t, MoveType mt = NORMAL, Piece promo = WP) 
-        : from(f), to(t), type(mt), promotion_piece(promo) {}
+    Move& operator[](size_t index) { return moves[index]; }
+    const Move& operator[](size_t index) const { return moves[index]; }
+    
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+
+private:
+    Move moves[MAX_MOVES];
+    size_t count;
+};
+
+enum class FenError {
+    NONE,
+    BAD_PIECE_PLACEMENT,
+    BAD_KING_COUNT,
+    BAD_PIECE_COUNT,
+    BAD_SIDE_TO_MOVE,
+    BAD_CASTLING,
+    BAD_EN_PASSANT,
+    BAD_MOVE_COUNTERS
 };
 
-typedef std::vector<Move> MoveList;
+// Everything make_move overwrites that cannot be recomputed from the move itself. The
+// caller owns each record (a search stack, a game history) and it must outlive the move;
+// the records of a line form a chain through previous, newest first.
+struct UndoInfo {
+    const UndoInfo* previous;
+    Move move;
+    Piece moved_piece;
+    Piece captured_piece;
+    int en_passant_square;
+    int castling_rights;
+    int halfmove_clock;
+    uint64_t hash_key;
+};
+
+// Squares covered by each piece type and side, computed once per node so move generation,
+// the search's check test and SEE share it. Side index 0 is white, 1 is black.
+struct AttackMap {
+    uint64_t by_piece[12];
+    uint64_t by_side[2];
+    // Enemy attacks with the side to move's king lifted off the board, so a king cannot
+    // hide from a slider behind itself: the squares that king may not step to
+    uint64_t king_danger;
+};
 
 class Board {
 public:
@@ -47,29 +140,91 @@ public:
     uint64_t white_pieces;
     uint64_t black_pieces;
     uint64_t all_pieces;
+    Piece piece_on[64];  // Mailbox mirror of bitboards, NO_PIECE on empty squares
     bool side_to_move;
     int en_passant_square;
     int castling_rights;
+    int halfmove_clock;
+    int fullmove_number;
+    uint64_t hash_key;
     
-    static uint64_t knight_attacks[64];
-    static uint64_t king_attacks[64];
+    const UndoInfo* history;  // Record of the last move made, nullptr once loaded from a FEN
+    
+    static constexpr const uint64_t* knight_attacks = ATTACK_TABLES.knight;
+    static constexpr const uint64_t* king_attacks = ATTACK_TABLES.king;
+    static constexpr const uint64_t (*pawn_attacks)[64] = ATTACK_TABLES.pawn;
+    static constexpr const uint64_t (*between)[64] = ATTACK_TABLES.between;
+    static constexpr const uint64_t (*line)[64] = ATTACK_TABLES.line;
     
     Board();
-    Board(const std::string& fen_string);
+    // Empty if the FEN is malformed; the reason goes to *error when given
+    static std::optional<Board> from_fen(std::string_view fen_string, FenError* error = nullptr);
     
-    void load_fen(const std::string& fen_string);
+    // Leaves the board untouched and returns the reason if the FEN is malformed
+    FenError load_fen(std::string_view fen_string);
+    // One FEN per line; blank lines are skipped and malformed ones counted in *rejected
+    static size_t load_fen_batch(std::string_view buffer, Board* boards, size_t capacity, size_t* rejected = nullptr);
+    static const char* fen_error_message(FenError error);
     void clear_board();
     void update_occupancy();
-    Square string_to_square(const std::string& square_str);
+    static Square string_to_square(std::string_view square_str);
     std::string to_fen_string() const;
+    static std::string move_to_string(const Move& move);
+    Piece piece_at(Square square) const;
+    uint64_t compute_hash_key() const;
+    // Records what unmake_move needs in undo and links it onto history
+    void make_move(const Move& move, UndoInfo& undo);
+    void unmake_move();
+    // Passes the turn; used by null-move pruning and never while in check
+    void make_null_move(UndoInfo& undo);
+    void unmake_null_move();
+    // True if the current position already occurred since the last capture or pawn move
+    bool is_repetition() const;
     void generate_pawn_moves(MoveList& move_list);
     void generate_knight_moves(MoveList& move_list);
     void generate_king_moves(MoveList& move_list);
     void generate_sliding_moves(MoveList& move_list);
     bool is_square_attacked(Square square, bool by_white) const;
+    // Union of the squares attacked by one colour's bishops, rooks and queens, flooded set-wise
+    uint64_t slider_attacks(bool white) const;
+    
+    // Attackers of both colours; pass a reduced occupancy to look through moved pieces
+    uint64_t attackers_to(Square square, uint64_t occupancy) const;
+    // Sliders that would attack the square once the first blocker on their ray is removed
+    uint64_t xray_attackers_to(Square square, uint64_t occupancy) const;
+    uint64_t attacked_squares(bool by_white, uint64_t occupancy) const;
+    AttackMap compute_attack_map() const;
+    // compute_attack_map() for the current position, cached until the board next changes
+    const AttackMap& attack_map() const;
+    bool in_check() const;
+    // Static exchange evaluation: centipawns the moving side nets once all captures on
+    // the target square are resolved, least valuable attacker first
+    int see(const Move& move) const;
     
+    // Fully legal generation: checkers, pins and the check-evasion mask are computed once
+    void generate_moves(MoveList& move_list);
+    void generate_captures(MoveList& move_list);
+    void generate_quiets(MoveList& move_list);
+    // Full legality check for moves that did not come from the generators (hash, killers)
+    bool is_legal(const Move& move);
+
 private:
-    char piece_to_char(Piece piece);
-    Piece char_to_piece(char c);
-    static void init_attack_tables();
+    mutable AttackMap attack_cache;
+    mutable bool attack_cache_valid = false;
+    
+    static char piece_to_char(Piece piece);
+    static Piece char_to_piece(char c);
+    
+    // Colour-specialised bodies behind the public generators, dispatched once on side_to_move
+    template<Color Us> void generate_pawn_moves(MoveList& move_list);
+    template<Color Us> void generate_knight_moves(MoveList& move_list);
+    template<Color Us> void generate_king_moves(MoveList& move_list);
+    template<Color Us> void generate_sliding_moves(MoveList& move_list);
+    template<Color Us, GenType Type> void generate_moves(MoveList& move_list);
+    template<Color Them> uint64_t attackers_of(Square square, uint64_t occupancy) const;
+    template<Color Them> uint64_t attacked_squares(uint64_t occupancy) const;
+    template<Color Us> void add_side_attacks(AttackMap& map) const;
+    template<Color Us> uint64_t pinned_pieces(Square king_square) const;
+    template<Color Us> bool is_pseudo_legal(const Move& move) const;
+    template<Color Us> static void add_promotions(MoveList& move_list, Square from, Square to);
 }; 
\ No newline at end of file
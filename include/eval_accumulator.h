@@ -0,0 +1,40 @@
+#pragma once
+
+#include "bitboard.h"
+#include "geometric_algebra.h"
+
+// Keeps GeometricEvaluator::evaluate_position's sum up to date along the search path.
+// push() diffs the new position's bitboards against the ply below and adds or removes
+// only the pieces that changed; sliders that did not move are recomputed only when a
+// square on their rays changed occupancy. pop() just returns to the ply below.
+class EvalAccumulator {
+public:
+    // Deeper than any search path, which ends at Search::MAX_PLY
+    static constexpr int MAX_DEPTH = 256;
+    
+    EvalAccumulator() : top(0) {}
+    
+    // Full recompute; the root of every search starts here
+    void reset(const Board& board);
+    // Call after make_move or make_null_move
+    void push(const Board& board);
+    // Call after unmake_move or unmake_null_move
+    void pop() { --top; }
+    
+    // Equal to evaluate_position(board) for the board last pushed
+    Multivector2D value(const Board& board) const;
+    
+private:
+    struct Entry {
+        uint64_t bitboards[12];
+        uint64_t occupancy;
+        // Pawn influence points the way the side to move plays, so both orientations are kept
+        Multivector2D pawns[2];
+        Multivector2D pieces;
+    };
+    
+    static void add_piece(Entry& entry, Piece piece, Square square, uint64_t occupancy, float sign);
+    
+    Entry stack[MAX_DEPTH];
+    int top;
+};
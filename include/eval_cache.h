@@ -0,0 +1,42 @@
+#pragma once
+
+#include "geometric_algebra.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Maps a position key (Board::hash_key) to its evaluate_position result. Shared by any
+// number of threads without locks, like the transposition table: each entry stores the
+// key xor a hash of both halves of the packed multivector. A read that mixes words from
+// two writes fails verification if any one data word differs, and otherwise passes only
+// on a 64-bit hash collision. The entry count is a power of two and a probe touches a
+// single entry.
+class EvalCache {
+public:
+    explicit EvalCache(size_t megabytes = 4);
+    
+    // Rounds down to a power-of-two number of entries
+    void resize(size_t megabytes);
+    // Also resets the counters
+    void clear();
+    
+    bool probe(uint64_t key, Multivector2D& result) const;
+    void store(uint64_t key, const Multivector2D& result);
+    
+    uint64_t hits() const { return hit_count.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return miss_count.load(std::memory_order_relaxed); }
+    size_t size() const { return mask + 1; }
+    
+private:
+    struct alignas(32) Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> low;
+        std::atomic<uint64_t> high;
+    };
+    
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+    mutable std::atomic<uint64_t> hit_count;
+    mutable std::atomic<uint64_t> miss_count;
+};
@@ -1,14 +1,20 @@
 #ifndef GEOMETRIC_ALGEBRA_H
 #define GEOMETRIC_ALGEBRA_H
 
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 // Estrutura para representar um vetor 2D
 struct Vector2D {
     float x;
     float y;
     
     // Construtores
-    Vector2D() : x(0.0f), y(0.0f) {}
-    Vector2D(float x_val, float y_val) : x(x_val), y(y_val) {}
+    constexpr Vector2D() : x(0.0f), y(0.0f) {}
+    constexpr Vector2D(float x_val, float y_val) : x(x_val), y(y_val) {}
 };
 
 // Estrutura para representar um bivetor em 2D (plano orientado)
@@ -16,42 +22,131 @@ struct Bivector2D {
     float magnitude;
     
     // Construtores
-    Bivector2D() : magnitude(0.0f) {}
-    Bivector2D(float mag) : magnitude(mag) {}
+    constexpr Bivector2D() : magnitude(0.0f) {}
+    constexpr Bivector2D(float mag) : magnitude(mag) {}
 };
 
-// Classe principal para multivetores em 2D
-class Multivector2D {
+#if defined(FIXED_POINT_EVAL)
+// Backend de ponto fixo: cada componente guarda valor * FIXED_POINT_SCALE em um inteiro, de
+// modo que somas são exatas e independentes da ordem, do compilador e da largura SIMD.
+// A escala é múltipla de 28 para que a mobilidade dos deslizantes (ataques / 14, dividida
+// em duas metades) seja representada sem arredondamento.
+constexpr int32_t FIXED_POINT_SCALE = 1008;
+#endif
+
+// Classe principal para multivetores em 2D. Os componentes ficam empacotados como
+// [escalar, e1, e2, e12] em 16 bytes alinhados, exatamente um registrador SSE.
+class alignas(16) Multivector2D {
+public:
+#if defined(FIXED_POINT_EVAL)
+    using Component = int32_t;
+    
+    // Arredonda para o inteiro mais próximo, metades para longe de zero
+    static constexpr Component to_component(float value) {
+        float scaled = value * FIXED_POINT_SCALE;
+        return static_cast<Component>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+    }
+    static constexpr float from_component(Component component) {
+        return static_cast<float>(component) / FIXED_POINT_SCALE;
+    }
+#else
+    using Component = float;
+    
+    static constexpr Component to_component(float value) { return value; }
+    static constexpr float from_component(Component component) { return component; }
+#endif
+
 private:
-    float scalar_part;
-    Vector2D vector_part;
-    Bivector2D bivector_part;
+    Component components[4];
 
 public:
     // Construtores
-    Multivector2D();
-    Multivector2D(float scalar);
-    Multivector2D(const Vector2D& vector);
-    Multivector2D(const Bivector2D& bivector);
-    Multivector2D(float scalar, const Vector2D& vector, const Bivector2D& bivector);
+    constexpr Multivector2D() : components{0, 0, 0, 0} {}
+    constexpr Multivector2D(float scalar) : components{to_component(scalar), 0, 0, 0} {}
+    constexpr Multivector2D(const Vector2D& vector) : components{0, to_component(vector.x), to_component(vector.y), 0} {}
+    constexpr Multivector2D(const Bivector2D& bivector) : components{0, 0, 0, to_component(bivector.magnitude)} {}
+    constexpr Multivector2D(float scalar, const Vector2D& vector, const Bivector2D& bivector)
+        : components{to_component(scalar), to_component(vector.x), to_component(vector.y), to_component(bivector.magnitude)} {}
+    
+    // Constrói diretamente a partir da representação interna de cada backend
+    static constexpr Multivector2D from_components(Component scalar, Component x, Component y, Component bivector) {
+        Multivector2D result;
+        result.components[0] = scalar;
+        result.components[1] = x;
+        result.components[2] = y;
+        result.components[3] = bivector;
+        return result;
+    }
     
     // Métodos de acesso
-    float get_scalar() const { return scalar_part; }
-    Vector2D get_vector() const { return vector_part; }
-    Bivector2D get_bivector() const { return bivector_part; }
+    constexpr float get_scalar() const { return from_component(components[0]); }
+    constexpr Vector2D get_vector() const { return Vector2D(from_component(components[1]), from_component(components[2])); }
+    constexpr Bivector2D get_bivector() const { return Bivector2D(from_component(components[3])); }
+    
+    constexpr void set_scalar(float scalar) { components[0] = to_component(scalar); }
+    constexpr void set_vector(const Vector2D& vector) { components[1] = to_component(vector.x); components[2] = to_component(vector.y); }
+    constexpr void set_bivector(const Bivector2D& bivector) { components[3] = to_component(bivector.magnitude); }
+    
+    // Operadores sobrecarregados, componente a componente (o compilador os junta em uma instrução SIMD)
+    constexpr Multivector2D operator+(const Multivector2D& other) const {
+        Multivector2D result;
+        for (int i = 0; i < 4; i++) {
+            result.components[i] = components[i] + other.components[i];
+        }
+        return result;
+    }
     
-    void set_scalar(float scalar) { scalar_part = scalar; }
-    void set_vector(const Vector2D& vector) { vector_part = vector; }
-    void set_bivector(const Bivector2D& bivector) { bivector_part = bivector; }
+    constexpr Multivector2D operator-(const Multivector2D& other) const {
+        Multivector2D result;
+        for (int i = 0; i < 4; i++) {
+            result.components[i] = components[i] - other.components[i];
+        }
+        return result;
+    }
     
-    // Operadores sobrecarregados
-    Multivector2D operator+(const Multivector2D& other) const;
-    Multivector2D operator*(float scalar) const;
+    // Em ponto fixo o produto é arredondado, exceto por escalares inteiros
+    constexpr Multivector2D operator*(float scalar) const {
+        Multivector2D result;
+        for (int i = 0; i < 4; i++) {
+#if defined(FIXED_POINT_EVAL)
+            result.components[i] = to_component(from_component(components[i]) * scalar);
+#else
+            result.components[i] = components[i] * scalar;
+#endif
+        }
+        return result;
+    }
+    
+    // Acumulação fundida: *this += multivector * weight, com um único arredondamento quando há FMA.
+    // Em ponto fixo o peso é arredondado para inteiro e a acumulação é exata.
+    Multivector2D& fma(const Multivector2D& multivector, float weight);
     
     // Operador de multiplicação por escalar (comutativo)
-    friend Multivector2D operator*(float scalar, const Multivector2D& mv);
+    friend constexpr Multivector2D operator*(float scalar, const Multivector2D& mv) { return mv * scalar; }
+    
+    friend Multivector2D geometric_product(const Multivector2D& a, const Multivector2D& b);
 };
 
+inline Multivector2D& Multivector2D::fma(const Multivector2D& multivector, float weight) {
+#if defined(FIXED_POINT_EVAL)
+    Component integer_weight = static_cast<Component>(weight < 0.0f ? weight - 0.5f : weight + 0.5f);
+    for (int i = 0; i < 4; i++) {
+        components[i] += multivector.components[i] * integer_weight;
+    }
+#elif defined(__FMA__)
+    __m128 product = _mm_fmadd_ps(_mm_load_ps(multivector.components), _mm_set1_ps(weight), _mm_load_ps(components));
+    _mm_store_ps(components, product);
+#elif defined(__SSE2__)
+    __m128 product = _mm_mul_ps(_mm_load_ps(multivector.components), _mm_set1_ps(weight));
+    _mm_store_ps(components, _mm_add_ps(_mm_load_ps(components), product));
+#else
+    for (int i = 0; i < 4; i++) {
+        components[i] = components[i] + multivector.components[i] * weight;
+    }
+#endif
+    return *this;
+}
+
 // Função para calcular o produto geométrico entre dois multivetores
 Multivector2D geometric_product(const Multivector2D& a, const Multivector2D& b);
 
@@ -59,4 +154,4 @@ Multivector2D geometric_product(const Multivector2D& a, const Multivector2D& b);
 float dot_product(const Vector2D& a, const Vector2D& b);
 float wedge_product(const Vector2D& a, const Vector2D& b);
 
-#endif // GEOMETRIC_ALGEBRA_H 
\ No newline at end of file
+#endif // GEOMETRIC_ALGEBRA_H
@@ -4,6 +4,9 @@
 #include "geometric_algebra.h"
 #include "bitboard.h"
 #include "magic_bitboards.h"
+#include "position_batch.h"
+#include "influence_tables.h"
+#include "eval_cache.h"
 
 enum class PieceType {
     PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING
@@ -12,20 +15,30 @@ enum class PieceType {
 class GeometricEvaluator {
 public:
     static Multivector2D calculate_piece_influence(PieceType piece, Square square, const Board& board);
+    static Multivector2D calculate_piece_influence(PieceType piece, Square square, uint64_t occupancy, bool white_to_move);
+    // One piece's weighted term of evaluate_position: the piece itself plus its influence
+    static Multivector2D piece_contribution(Piece piece, Square square, uint64_t occupancy, bool white_to_move);
     static Multivector2D evaluate_position(const Board& board);
+    // Same result, looked up by board.hash_key first and stored on a miss
+    static Multivector2D evaluate_position(const Board& board, EvalCache& cache);
+    // results[i] = evaluate_position(board i) for every position in the batch, bit for bit
+    static void evaluate_batch(const PositionBatch& batch, Multivector2D* results);
     static float get_final_score(const Multivector2D& m_total);
+    // Bivector of a slider set's mobility, attack_count / 14
+    static Multivector2D slider_influence(int attack_count);
     static PieceType piece_to_type(Piece piece);
-    
+
 private:
-    static Multivector2D calculate_pawn_influence(Square square, const Board& board);
-    static Multivector2D calculate_knight_influence(Square square, const Board& board);
-    static Multivector2D calculate_bishop_influence(Square square, const Board& board);
-    static Multivector2D calculate_rook_influence(Square square, const Board& board);
-    static Multivector2D calculate_queen_influence(Square square, const Board& board);
-    static Multivector2D calculate_king_influence(Square square, const Board& board);
+    // Influence kernels: table lookups for the occupancy-independent pieces, attack
+    // popcounts for sliders. Specialised per type so the evaluation loop never branches on it.
+    template<PieceType Type>
+    static Multivector2D calculate_influence(Square square, uint64_t occupancy, bool white_to_move);
+    template<Piece P>
+    static void add_pieces(Multivector2D& m_total, const Board& board);
+    template<Piece P>
+    static void add_sliders(Multivector2D& m_total, const Board& board);
     
     static int popcount(uint64_t bitboard);
-    static Vector2D square_to_coords(Square square);
     static float get_piece_weight(Piece piece);
 };
 
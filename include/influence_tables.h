@@ -0,0 +1,74 @@
+#pragma once
+
+// Occupancy-independent piece influences, summed at compile time from the same move
+// vectors the evaluator used to add up on every call.
+//
+// The move vectors are not clipped at the board edge, so every square of a table holds
+// the same entry. The knight and king vectors cancel out to zero, which leaves the pawn
+// entries, (0, 3) with white to move and (0, -3) with black to move, as the only nonzero
+// terms. evaluate_batch relies on that shape and static_asserts it.
+struct InfluenceTerm {
+    float x;
+    float y;
+    float bivector;
+};
+
+struct InfluenceTables {
+    InfluenceTerm pawn[2][64];   // [0] white to move, [1] black to move
+    InfluenceTerm knight[64];
+    InfluenceTerm king[64];
+};
+
+constexpr InfluenceTerm sum_vectors(const float (&vectors)[8][2], int count) {
+    InfluenceTerm term{};
+    for (int i = 0; i < count; i++) {
+        term.x += vectors[i][0];
+        term.y += vectors[i][1];
+    }
+    return term;
+}
+
+constexpr InfluenceTables make_influence_tables() {
+    InfluenceTables tables{};
+
+    // Pawns push and capture towards the side to move's far rank
+    const float white_pawn_moves[8][2] = {{0.0f, 1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}};
+    const float black_pawn_moves[8][2] = {{0.0f, -1.0f}, {-1.0f, -1.0f}, {1.0f, -1.0f}};
+    const float knight_moves[8][2] = {
+        {1.0f, 2.0f}, {2.0f, 1.0f}, {2.0f, -1.0f}, {1.0f, -2.0f},
+        {-1.0f, -2.0f}, {-2.0f, -1.0f}, {-2.0f, 1.0f}, {-1.0f, 2.0f}
+    };
+    const float king_moves[8][2] = {
+        {-1.0f, -1.0f}, {-1.0f, 0.0f}, {-1.0f, 1.0f},
+        {0.0f, -1.0f}, {0.0f, 1.0f},
+        {1.0f, -1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}
+    };
+
+    for (int square = 0; square < 64; square++) {
+        tables.pawn[0][square] = sum_vectors(white_pawn_moves, 3);
+        tables.pawn[1][square] = sum_vectors(black_pawn_moves, 3);
+        tables.knight[square] = sum_vectors(knight_moves, 8);
+        tables.king[square] = sum_vectors(king_moves, 8);
+    }
+
+    return tables;
+}
+
+inline constexpr InfluenceTables INFLUENCE_TABLES = make_influence_tables();
+
+// True when all 64 entries equal square 0's and its components are whole numbers, so a
+// table's total over a piece set is the piece count times that one entry, exactly
+constexpr bool is_uniform_integral(const InfluenceTerm (&table)[64]) {
+    const InfluenceTerm& first = table[0];
+    if (first.x != static_cast<float>(static_cast<int>(first.x)) ||
+        first.y != static_cast<float>(static_cast<int>(first.y)) ||
+        first.bivector != static_cast<float>(static_cast<int>(first.bivector))) {
+        return false;
+    }
+    for (int square = 1; square < 64; square++) {
+        if (table[square].x != first.x || table[square].y != first.y || table[square].bivector != first.bivector) {
+            return false;
+        }
+    }
+    return true;
+}
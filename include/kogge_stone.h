@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Set-wise sliding attacks: every rook, bishop and queen of a set is flooded at once
+// with Kogge-Stone occluded fills instead of one table lookup per piece. Built with
+// AVX2, four ray directions run side by side in the 64-bit lanes of one register.
+class KoggeStone {
+public:
+    // Union of all squares attacked by orthogonal and diagonal sliders through occupancy
+    static uint64_t slider_attacks(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy);
+    static uint64_t rook_attacks(uint64_t rooks, uint64_t occupancy);
+    static uint64_t bishop_attacks(uint64_t bishops, uint64_t occupancy);
+    // Sum of every slider's own attack count. A ray stops on the next piece, so the fills of
+    // one direction never overlap and counting them per direction equals counting per piece
+    static int slider_mobility(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy);
+    
+private:
+    static uint64_t slider_attacks_scalar(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy);
+    static int slider_mobility_scalar(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy);
+#if defined(__AVX2__)
+    static uint64_t slider_attacks_avx2(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy);
+    static int slider_mobility_avx2(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy);
+#endif
+};
@@ -1,42 +1,63 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <array>
 
+#include "magic_numbers.h"
+
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
+
+// Slider attacks are indexed either by fancy magic multiplication or, when built with
+// USE_PEXT, by BMI2 parallel bit extraction. Both index into one contiguous arena.
+// The magics and shifts come from magic_numbers.h, written by tools/magic_finder.
 class MagicBitboards {
 public:
+#if defined(USE_PEXT)
+    static constexpr size_t ROOK_TABLE_SIZE = 102400;
+    static constexpr size_t BISHOP_TABLE_SIZE = 5248;
+#else
+    static constexpr size_t ROOK_TABLE_SIZE = ROOK_MAGIC_TABLE_SIZE;
+    static constexpr size_t BISHOP_TABLE_SIZE = BISHOP_MAGIC_TABLE_SIZE;
+#endif
+    
     static void init();
-    static uint64_t get_rook_attacks(int square, uint64_t blockers);
-    static uint64_t get_bishop_attacks(int square, uint64_t blockers);
+    static uint64_t generate_blocker_mask(int square, bool is_rook);
+    static uint64_t generate_attack_mask(int square, uint64_t blockers, bool is_rook);
+    
+    static uint64_t get_rook_attacks(int square, uint64_t blockers) {
+        const MagicEntry& entry = rook_magics[square];
+        return entry.attacks[attack_index(entry, blockers)];
+    }
+    
+    static uint64_t get_bishop_attacks(int square, uint64_t blockers) {
+        const MagicEntry& entry = bishop_magics[square];
+        return entry.attacks[attack_index(entry, blockers)];
+    }
     
 private:
     struct MagicEntry {
-        uint64_t magic;
-        uint64_t mask;
         uint64_t* attacks;
+        uint64_t mask;
+        uint64_t magic;
         int shift;
     };
     
+    static uint64_t attack_index(const MagicEntry& entry, uint64_t blockers) {
+#if defined(USE_PEXT)
+        return _pext_u64(blockers, entry.mask);
+#else
+        return ((blockers & entry.mask) * entry.magic) >> entry.shift;
+#endif
+    }
+    
     static std::array<MagicEntry, 64> rook_magics;
     static std::array<MagicEntry, 64> bishop_magics;
+    alignas(64) static uint64_t attack_table[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE];
     
-    static uint64_t find_magic_number(int square, bool is_rook);
-    static uint64_t generate_blocker_mask(int square, bool is_rook);
-    static uint64_t generate_attack_mask(int square, uint64_t blockers, bool is_rook);
     static void init_magic_entries();
-    static bool verify_magic_number(uint64_t magic, int square, bool is_rook);
-    
-    static constexpr uint64_t ROOK_MAGICS[64] = {
-        0x8a80104000800020ULL, 0x140002000100040ULL, 0x2801880a0017001ULL, 0x1000100010002ULL,
-        0x2000200010002ULL, 0x2000100010002ULL, 0x2000100010002ULL, 0x2000100010002ULL,
-        0x2000100010002ULL, 0x2000100010002ULL, 0x2000100010002ULL, 0x2000100010002ULL,
-        0x2000100010002ULL, 0x2000100010002ULL, 0x2000100010002ULL, 0x2000100010002ULL,
-    };
+    static uint64_t* fill_attack_table(MagicEntry& entry, uint64_t* table, int square, bool is_rook);
     
-    static constexpr uint64_t BISHOP_MAGICS[64] = {
-        0x40040844404084ULL, 0x2004208a004208ULL, 0x10190041080202ULL, 0x108060845042010ULL,
-        0x581104180800210ULL, 0x2112080446200010ULL, 0x1080820820060210ULL, 0x3c0808410220200ULL,
-        0x4050404440404ULL, 0x21001420088ULL, 0x24d0080801082102ULL, 0x1020a0a020400ULL,
-        0x40308200402ULL, 0x4011002100800ULL, 0x401484104104005ULL, 0x801010402020200ULL,
-    };
 }; 
\ No newline at end of file
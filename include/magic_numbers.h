@@ -0,0 +1,62 @@
+#pragma once
+
+// Generated by tools/magic_finder.cpp - do not edit by hand.
+// Regenerate with: magic_finder --output include/magic_numbers.h
+
+#include <cstddef>
+#include <cstdint>
+
+inline constexpr uint64_t ROOK_MAGICS[64] = {
+    0x8000102080400aULL, 0x4440004020001002ULL, 0x12000a0080402012ULL, 0x480040800811000ULL,
+    0x280228008000400ULL, 0x9200100108040200ULL, 0x2080008002000100ULL, 0x8008800429c100ULL,
+    0x802040008002ULL, 0x802000804000ULL, 0x2001024420080ULL, 0x4000801000080080ULL,
+    0x4040800400820800ULL, 0x10800400020080ULL, 0x4000112181024ULL, 0x3000900004082ULL,
+    0x308008400d600240ULL, 0x1210004000200040ULL, 0x100110020010040ULL, 0x6800090023001000ULL,
+    0x4008004800802ULL, 0x2002010100080400ULL, 0x8004010100040200ULL, 0x1120000a40041ULL,
+    0x400080208000ULL, 0x100200040005000ULL, 0x2880200080100085ULL, 0x1010100080800800ULL,
+    0x9280040080080082ULL, 0x40e004e00100c28ULL, 0x20414400021008ULL, 0x10004200041891ULL,
+    0x442008042002100ULL, 0x20002080804008ULL, 0x10080020200400ULL, 0x60c801000800800ULL,
+    0x8022240082800800ULL, 0x5000204008010410ULL, 0x900164000882ULL, 0x4002004082000104ULL,
+    0x8000804000208008ULL, 0x402010004004ULL, 0x2000102001010040ULL, 0x4420100008008080ULL,
+    0x102001048260020ULL, 0x2002000400808002ULL, 0x8000080210040001ULL, 0x2405804c020021ULL,
+    0x100800040102080ULL, 0x80004a2500820200ULL, 0x1002000c89300ULL, 0x100008008480ULL,
+    0x8008080080040080ULL, 0x400040080020080ULL, 0x2001081002010400ULL, 0x20800100004080ULL,
+    0x1680001100402081ULL, 0x44a1034009801221ULL, 0xa00901a000400a11ULL, 0x503205805001001ULL,
+    0x2401000248001005ULL, 0x4815004844000201ULL, 0x4000010810008204ULL, 0xa000010080204402ULL,
+};
+
+inline constexpr int ROOK_SHIFTS[64] = {
+    52, 53, 53, 53, 53, 53, 53, 52, 53, 54, 54, 54, 54, 54, 54, 53,
+    53, 54, 54, 54, 54, 54, 54, 53, 53, 54, 54, 54, 54, 54, 54, 53,
+    53, 54, 54, 54, 54, 54, 54, 53, 53, 54, 54, 54, 54, 54, 54, 53,
+    53, 54, 54, 54, 54, 54, 54, 53, 52, 53, 53, 53, 53, 53, 53, 52,
+};
+
+inline constexpr uint64_t BISHOP_MAGICS[64] = {
+    0x202048102020200ULL, 0x2010106101002100ULL, 0x112040042040004ULL, 0x2ac9040503800100ULL,
+    0xc06c102844001003ULL, 0x1041242060000060ULL, 0x4400510420200000ULL, 0x128180240a200490ULL,
+    0x20020822a420420ULL, 0x810088208020430ULL, 0x8080204003108ULL, 0x128040400840202ULL,
+    0x20040420040820ULL, 0x20210048010ULL, 0x800008230104480ULL, 0x114a0084410842ULL,
+    0x4002020042134ULL, 0x1082181022180110ULL, 0x20820c408001010ULL, 0x2004c01220004ULL,
+    0x10a000401210504ULL, 0x800400200502408ULL, 0x811108080288ULL, 0x2502800440484800ULL,
+    0x82400110108210ULL, 0x504113120010100ULL, 0x18010788020020ULL, 0x20048008008050ULL,
+    0x1830840002020200ULL, 0x1206420003048212ULL, 0x208400401080aULL, 0x2220880124400d2ULL,
+    0x8010082000090280ULL, 0x20021010c0043148ULL, 0x2050203400180800ULL, 0x2002040401080210ULL,
+    0x8000810200040208ULL, 0x90004080011002ULL, 0x1042120400c0c10ULL, 0x10480a0220008c80ULL,
+    0x60510225000e004ULL, 0x4051809001230ULL, 0x632001844000804ULL, 0xaa018000100ULL,
+    0x2111080104000040ULL, 0x4820094101080200ULL, 0x2011104100400901ULL, 0x4a1c04048200a4ULL,
+    0x204208a0288800ULL, 0x830880d0080400ULL, 0x100a0205148000ULL, 0x8009200c20880100ULL,
+    0x9884241020220521ULL, 0x1040401042008040ULL, 0x204485001220070ULL, 0x24142404e4010008ULL,
+    0x4010120202200400ULL, 0x40e0080845000ULL, 0x8001080100809008ULL, 0x120c200201840c20ULL,
+    0x4000020442406ULL, 0x100a004500082ULL, 0x2014a0218480108ULL, 0x8029220082040100ULL,
+};
+
+inline constexpr int BISHOP_SHIFTS[64] = {
+    58, 59, 59, 59, 59, 59, 59, 58, 59, 59, 59, 59, 59, 59, 59, 59,
+    59, 59, 57, 57, 57, 57, 59, 59, 59, 59, 57, 55, 55, 57, 59, 59,
+    59, 59, 57, 55, 55, 57, 59, 59, 59, 59, 57, 57, 57, 57, 59, 59,
+    59, 59, 59, 59, 59, 59, 59, 59, 58, 59, 59, 59, 59, 59, 59, 58,
+};
+
+inline constexpr size_t ROOK_MAGIC_TABLE_SIZE = 102400;
+inline constexpr size_t BISHOP_MAGIC_TABLE_SIZE = 5248;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "bitboard.h"
+
+struct ScoredMove {
+    Move move;
+    int score;
+};
+
+// A move list with ordering scores. pick_best selects lazily instead of sorting up front:
+// most nodes cut off after a move or two, so a full sort is wasted work there.
+class ScoredMoveList {
+public:
+    ScoredMoveList() : count(0) {}
+    
+    void push_back(const Move& move, int score) { moves[count++] = {move, score}; }
+    void clear() { count = 0; }
+    size_t size() const { return count; }
+    
+    // Swaps the highest-scored move among [index, size()) into index and returns it
+    const ScoredMove& pick_best(size_t index);
+
+private:
+    ScoredMove moves[MoveList::MAX_MOVES];
+    size_t count;
+};
+
+// Quiet-move statistics gathered while searching; each search thread owns one
+struct SearchHeuristics {
+    // History scores saturate towards +/-MAX_HISTORY instead of growing without bound
+    static constexpr int MAX_HISTORY = 16384;
+    
+    int history[12][64];        // [moved piece][to]
+    int butterfly[2][64][64];   // [Color][from][to]
+    Move countermoves[12][64];  // Refutation of the previous move, by its [moved piece][to]
+    
+    void clear();
+    int quiet_score(const Board& board, const Move& move) const;
+    // Positive bonus for a quiet move that caused a cutoff, negative for ones tried before it
+    void update_history(const Board& board, const Move& move, int bonus);
+};
+
+// Hands out legal moves one at a time for search. Each stage is generated only once
+// the previous one runs dry, so a cutoff on the hash move or an early capture never
+// pays for quiet-move generation. Stages: hash move, captures by MVV-LVA, killers,
+// countermove, quiets by history.
+class MovePicker {
+public:
+    static constexpr int MAX_KILLERS = 2;
+    
+    // killers holds MAX_KILLERS entries; killers and heuristics may be null
+    MovePicker(Board& board, Move hash_move, const Move* killers = nullptr,
+               const SearchHeuristics* heuristics = nullptr, Move countermove = Move());
+    // Quiescence: captures and promotions only, by MVV-LVA
+    explicit MovePicker(Board& board);
+    
+    // Returns Move() once every stage is exhausted
+    Move next_move();
+
+private:
+    enum Stage {
+        HASH_MOVE,
+        GENERATE_CAPTURES,
+        CAPTURES,
+        KILLERS,
+        COUNTERMOVE,
+        GENERATE_QUIETS,
+        QUIETS,
+        DONE
+    };
+    
+    void load_stage(const MoveList& move_list, bool captures);
+    int capture_score(const Move& move) const;
+    bool is_quiet_candidate(const Move& move) const;
+    bool is_killer(const Move& move) const;
+    
+    Board& board;
+    Move hash_move;
+    Move killers[MAX_KILLERS];
+    Move countermove;
+    const SearchHeuristics* heuristics;
+    
+    Stage stage;
+    bool captures_only;
+    ScoredMoveList moves;
+    size_t current;
+    int killer_index;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "bitboard.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Positions in structure-of-arrays layout for batch evaluation: bitboards[piece][i] is the
+// piece's bitboard in position i, so one piece type of LANES neighbouring positions sits in
+// contiguous memory. Storage is padded with empty positions to a whole number of lane groups.
+struct PositionBatch {
+    static constexpr size_t LANES = 8;
+    
+    std::vector<uint64_t> bitboards[12];
+    std::vector<uint64_t> occupancy;
+    std::vector<uint8_t> white_to_move;
+    
+    PositionBatch() : count(0) {}
+    PositionBatch(const Board* boards, size_t count) : count(0) { assign(boards, count); }
+    
+    void assign(const Board* boards, size_t count);
+    size_t size() const { return count; }
+    size_t padded_size() const { return occupancy.size(); }
+    
+private:
+    size_t count;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "bitboard.h"
+#include "eval_accumulator.h"
+#include "move_picker.h"
+#include "transposition_table.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Zero means no limit; the search also stops early when stop() is called
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t time_ms = 0;
+    // Keep the result until stop() even after a mate or the depth cap ends the search (UCI go infinite)
+    bool infinite = false;
+};
+
+// One line per completed iteration; score is in centipawns from the side to move
+struct SearchReport {
+    int depth;
+    int score;
+    uint64_t nodes;
+    uint64_t nps;
+    int64_t time_ms;
+    int hashfull;
+    std::vector<Move> pv;
+};
+
+// Negamax alpha-beta with iterative deepening, principal variation search,
+// null-move pruning and late-move reductions, ending in a SEE-pruned quiescence
+// search. Leaves are scored by GeometricEvaluator::get_final_score.
+//
+// With more than one thread the search runs Lazy SMP: every helper searches the
+// same root on its own board, skipping some depths so the threads spread out, and
+// the threads cooperate only through the shared transposition table. The main
+// thread alone reports and decides the move.
+class Search {
+public:
+    static constexpr int MAX_PLY = 128;
+    static constexpr int INFINITE_SCORE = 32001;
+    static constexpr int MATE_SCORE = 32000;
+    // Scores beyond this are mates, MATE_SCORE minus the distance in plies
+    static constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+    
+    using Reporter = std::function<void(const SearchReport&)>;
+    
+    explicit Search(TranspositionTable& table, int threads = 1);
+    ~Search();
+    
+    void set_threads(int threads);
+    int thread_count() const { return static_cast<int>(workers.size()); }
+    
+    // Returns the best move of the deepest completed iteration, or Move() if there is none
+    Move think(const Board& board, const SearchLimits& limits, const Reporter& reporter = nullptr);
+    // Safe to call from another thread while think() runs
+    void stop() { stopped.store(true, std::memory_order_relaxed); }
+    uint64_t total_nodes() const;
+    
+    static int evaluate(const Board& board);
+
+private:
+    // Everything a thread writes during the search; only nodes is read by other threads
+    struct Worker {
+        int id;
+        Board board;
+        std::atomic<uint64_t> nodes;
+        Move best_move;
+        
+        Move pv[MAX_PLY][MAX_PLY];
+        int pv_length[MAX_PLY];
+        Move killers[MAX_PLY][MovePicker::MAX_KILLERS];
+        // undo[ply] records the move made at ply; the root links onto the game's own history
+        UndoInfo undo[MAX_PLY];
+        SearchHeuristics heuristics;
+        EvalAccumulator accumulator;
+    };
+    
+    // Same score as evaluate(worker.board), from the incrementally maintained accumulator
+    static int evaluate(const Worker& worker);
+    static void make_move(Worker& worker, const Move& move, int ply);
+    static void unmake_move(Worker& worker);
+    
+    void iterate(Worker& worker, const Reporter* reporter);
+    int negamax(Worker& worker, int depth, int ply, int alpha, int beta, bool allow_null);
+    // Captures only (all evasions when in check) until the position is quiet
+    int qsearch(Worker& worker, int ply, int alpha, int beta);
+    bool should_stop(Worker& worker);
+    static bool has_non_pawn_material(const Board& board);
+    static Move countermove_for(const Worker& worker);
+    static void update_quiet_stats(Worker& worker, const Move& move, int ply, int depth,
+                                   const Move* tried_quiets, int tried_count);
+    static int score_to_tt(int score, int ply);
+    static int score_from_tt(int score, int ply);
+    
+    TranspositionTable& table;
+    std::vector<std::unique_ptr<Worker>> workers;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start_time;
+    std::atomic<bool> stopped;
+    
+    int reductions[64][64];
+};
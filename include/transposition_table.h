@@ -0,0 +1,69 @@
+#pragma once
+
+#include "bitboard.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum Bound : uint8_t {
+    BOUND_NONE,
+    BOUND_UPPER,
+    BOUND_LOWER,
+    BOUND_EXACT
+};
+
+struct TTData {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Shared by all search threads without locks. Each entry stores key ^ data next to
+// data, so a torn write from a racing thread fails verification and reads as a miss.
+// Entries are grouped four to a 64-byte bucket, so a probe touches a single cache line.
+class TranspositionTable {
+public:
+    static constexpr int ENTRIES_PER_BUCKET = 4;
+    // Depth is packed into 8 signed bits; deeper results are stored as this depth
+    static constexpr int MAX_DEPTH = 127;
+    
+    explicit TranspositionTable(size_t megabytes = 16);
+    
+    void resize(size_t megabytes);
+    void clear();
+    // Ages existing entries so they lose replacement priority to the new search
+    void new_search() { generation = (generation + 1) & 0x3F; }
+    
+    // Scores are stored as given; the caller converts mate scores to distance from this node
+    bool probe(uint64_t key, TTData& data) const;
+    void store(uint64_t key, Move move, int score, int depth, Bound bound);
+    
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+    size_t bucket_count() const { return count; }
+    
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+    
+    struct alignas(64) Bucket {
+        Entry entries[ENTRIES_PER_BUCKET];
+    };
+    
+    // data layout: move (0-15), score (16-31), depth (32-39), bound (40-41), generation (42-47)
+    static uint64_t pack(Move move, int score, int depth, Bound bound, int generation);
+    static int unpack_depth(uint64_t data) { return static_cast<int8_t>((data >> 32) & 0xFF); }
+    static int unpack_generation(uint64_t data) { return static_cast<int>((data >> 42) & 0x3F); }
+    
+    Bucket& bucket_for(uint64_t key) const {
+        return buckets[static_cast<size_t>((static_cast<unsigned __int128>(key) * count) >> 64)];
+    }
+    
+    std::unique_ptr<Bucket[]> buckets;
+    size_t count;
+    int generation;
+};
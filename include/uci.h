@@ -0,0 +1,55 @@
+#pragma once
+
+#include "bitboard.h"
+#include "search.h"
+#include "transposition_table.h"
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Universal Chess Interface frontend. Commands are read from in and answered on out;
+// the search runs on its own thread so stop, isready and quit are handled at once.
+class UciEngine {
+public:
+    static constexpr int DEFAULT_HASH_MB = 16;
+    static constexpr int MAX_HASH_MB = 65536;
+    static constexpr int MAX_THREADS = 256;
+    
+    UciEngine(std::istream& in, std::ostream& out);
+    ~UciEngine();
+    
+    // Returns when quit is received or the input ends
+    void loop();
+    
+private:
+    void handle_uci();
+    void handle_setoption(std::istringstream& command);
+    void handle_position(std::istringstream& command);
+    void handle_go(std::istringstream& command);
+    // Stops a running search and waits for its bestmove to be printed. Every command that
+    // changes what the search reads calls this first, so none of them blocks on go infinite.
+    void stop_search();
+    
+    // Returns Move() unless text names a legal move in the current position
+    Move parse_move(const std::string& text);
+    void send(const std::string& line);
+    static std::string format_score(int score);
+    
+    std::istream& in;
+    std::ostream& out;
+    std::mutex output_mutex;
+    
+    TranspositionTable table;
+    Search search;
+    Board board;
+    // Undo records of the moves after the position command's FEN, which repetition detection
+    // walks back through; a deque never moves them as it grows
+    std::deque<UndoInfo> game_history;
+    
+    std::thread search_thread;
+    std::atomic<bool> searching;
+};
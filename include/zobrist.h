@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+// Random keys for the 64-bit position hash, generated at compile time (splitmix64)
+struct ZobristKeys {
+    uint64_t pieces[12][64];
+    uint64_t side;
+    uint64_t castling[16];
+    uint64_t en_passant_file[8];
+};
+
+constexpr uint64_t zobrist_next(uint64_t& state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t value = state;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+constexpr ZobristKeys make_zobrist_keys() {
+    ZobristKeys keys{};
+    uint64_t state = 0x51A7E5C0FFEE1234ULL;
+    
+    for (int piece = 0; piece < 12; piece++) {
+        for (int square = 0; square < 64; square++) {
+            keys.pieces[piece][square] = zobrist_next(state);
+        }
+    }
+    
+    keys.side = zobrist_next(state);
+    
+    // Each right gets its own key; combinations are the XOR of their parts
+    uint64_t rights[4] = {zobrist_next(state), zobrist_next(state), zobrist_next(state), zobrist_next(state)};
+    for (int mask = 0; mask < 16; mask++) {
+        for (int right = 0; right < 4; right++) {
+            if (mask & (1 << right)) {
+                keys.castling[mask] ^= rights[right];
+            }
+        }
+    }
+    
+    for (int file = 0; file < 8; file++) {
+        keys.en_passant_file[file] = zobrist_next(state);
+    }
+    
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = make_zobrist_keys();
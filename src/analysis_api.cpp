@@ -1,8 +1,16 @@
 #include "analysis_api.h"
+#include "kogge_stone.h"
 #include <cmath>
 
 std::string AnalysisApi::generate_analysis_json(const Board& board) {
-    Multivector2D M_total = GeometricEvaluator::evaluate_position(board);
+    return build_analysis_json(board, GeometricEvaluator::evaluate_position(board));
+}
+
+std::string AnalysisApi::generate_analysis_json(const Board& board, EvalCache& cache) {
+    return build_analysis_json(board, GeometricEvaluator::evaluate_position(board, cache));
+}
+
+std::string AnalysisApi::build_analysis_json(const Board& board, const Multivector2D& M_total) {
     nlohmann::json j;
     
     j["fen"] = board.to_fen_string();
@@ -17,6 +25,8 @@ std::string AnalysisApi::generate_analysis_json(const Board& board) {
     
     j["visualizations"]["heatmap"] = generate_heatmap(M_total);
     j["visualizations"]["bivectors"] = generate_bivectors(board);
+    j["visualizations"]["slider_control"]["white"] = squares_to_json(board.slider_attacks(true));
+    j["visualizations"]["slider_control"]["black"] = squares_to_json(board.slider_attacks(false));
     
     return j.dump();
 }
@@ -27,6 +37,15 @@ std::string AnalysisApi::square_to_string(Square square) {
     return std::string(1, 'a' + file) + std::string(1, '1' + rank);
 }
 
+nlohmann::json AnalysisApi::squares_to_json(uint64_t squares) {
+    nlohmann::json list = nlohmann::json::array();
+    for (; squares; squares &= squares - 1) {
+        list.push_back(square_to_string(static_cast<Square>(__builtin_ctzll(squares))));
+    }
+    
+    return list;
+}
+
 std::string AnalysisApi::piece_to_string(Piece piece, Square square) {
     char piece_char;
     switch (piece) {
@@ -98,15 +117,17 @@ nlohmann::json AnalysisApi::generate_bivectors(const Board& board) {
     Piece sliding_pieces[] = {WB, WR, WQ, BB, BR, BQ};
     
     for (Piece piece_type : sliding_pieces) {
-        uint64_t piece_bitboard = board.bitboards[piece_type];
+        PieceType type = GeometricEvaluator::piece_to_type(piece_type);
         
-        while (piece_bitboard) {
-            int square_index = __builtin_ctzll(piece_bitboard);
-            Square square = static_cast<Square>(square_index);
+        for (uint64_t piece_bitboard = board.bitboards[piece_type]; piece_bitboard; piece_bitboard &= piece_bitboard - 1) {
+            Square square = static_cast<Square>(__builtin_ctzll(piece_bitboard));
             
-            PieceType type = GeometricEvaluator::piece_to_type(piece_type);
-            Multivector2D influence = GeometricEvaluator::calculate_piece_influence(type, square, board);
+            // A one-piece set through the same fills evaluate_position floods whole sets with
+            uint64_t piece = 1ULL << square;
+            uint64_t diagonal = type == PieceType::ROOK ? 0ULL : KoggeStone::bishop_attacks(piece, board.all_pieces);
+            uint64_t orthogonal = type == PieceType::BISHOP ? 0ULL : KoggeStone::rook_attacks(piece, board.all_pieces);
             
+            Multivector2D influence = GeometricEvaluator::slider_influence(__builtin_popcountll(diagonal) + __builtin_popcountll(orthogonal));
             float bivector_strength = std::abs(influence.get_bivector().magnitude);
             
             if (bivector_strength > 0.01f) {
@@ -114,33 +135,11 @@ nlohmann::json AnalysisApi::generate_bivectors(const Board& board) {
                 bivector_data["piece"] = piece_to_string(piece_type, square);
                 bivector_data["strength"] = bivector_strength;
                 
-                nlohmann::json path = nlohmann::json::array();
-                
-                if (type == PieceType::BISHOP || type == PieceType::QUEEN) {
-                    uint64_t attacks = MagicBitboards::get_bishop_attacks(square_index, board.all_pieces);
-                    while (attacks) {
-                        int attack_square = __builtin_ctzll(attacks);
-                        path.push_back(square_to_string(static_cast<Square>(attack_square)));
-                        attacks &= attacks - 1;
-                    }
-                }
-                
-                if (type == PieceType::ROOK || type == PieceType::QUEEN) {
-                    uint64_t attacks = MagicBitboards::get_rook_attacks(square_index, board.all_pieces);
-                    while (attacks) {
-                        int attack_square = __builtin_ctzll(attacks);
-                        path.push_back(square_to_string(static_cast<Square>(attack_square)));
-                        attacks &= attacks - 1;
-                    }
-                }
-                
-                bivector_data["path"] = path;
+                bivector_data["path"] = squares_to_json(diagonal | orthogonal);
                 bivectors.push_back(bivector_data);
             }
-            
-            piece_bitboard &= piece_bitboard - 1;
         }
     }
     
     return bivectors;
-} 
\ No newline at end of file
+}
@@ -1,63 +1,81 @@
 #include "bitboard.h"
 #include "magic_bitboards.h"
-#include <sstream>
+#include "kogge_stone.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 
-uint64_t Board::knight_attacks[64] = {0};
-uint64_t Board::king_attacks[64] = {0};
-
-const int knight_offsets[8][2] = {
-    {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-    {1, -2}, {1, 2}, {2, -1}, {2, 1}
+// Rights that survive a move touching each square (king or rook moved/captured)
+const int castling_rights_mask[64] = {
+    13, 15, 15, 15, 12, 15, 15, 14,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     7, 15, 15, 15,  3, 15, 15, 11
 };
 
-const int king_offsets[8][2] = {
-    {-1, -1}, {-1, 0}, {-1, 1},
-    {0, -1}, {0, 1},
-    {1, -1}, {1, 0}, {1, 1}
-};
+// Exchange values for see(), indexed by piece % 6; in step with the evaluator's weights
+const int see_piece_value[6] = {100, 300, 300, 500, 900, 20000};
 
-void Board::init_attack_tables() {
-    for (int square = 0; square < 64; square++) {
-        int rank = square / 8;
-        int file = square % 8;
-        
-        for (const auto& offset : knight_offsets) {
-            int new_rank = rank + offset[0];
-            int new_file = file + offset[1];
-            
-            if (new_rank >= 0 && new_rank < 8 && new_file >= 0 && new_file < 8) {
-                int target_square = new_rank * 8 + new_file;
-                knight_attacks[square] |= 1ULL << target_square;
-            }
-        }
-    }
-    
-    for (int square = 0; square < 64; square++) {
-        int rank = square / 8;
-        int file = square % 8;
-        
-        for (const auto& offset : king_offsets) {
-            int new_rank = rank + offset[0];
-            int new_file = file + offset[1];
-            
-            if (new_rank >= 0 && new_rank < 8 && new_file >= 0 && new_file < 8) {
-                int target_square = new_rank * 8 + new_file;
-                king_attacks[square] |= 1ULL << target_square;
-            }
-        }
-    }
+// Board geometry seen from one side, folded to constants in each Color instantiation
+template<Color Us>
+constexpr Piece relative_piece(Piece white_piece) {
+    return static_cast<Piece>(Us == WHITE ? white_piece : white_piece + 6);
+}
+
+// Rank 0 is our back rank, rank 7 the promotion rank
+template<Color Us>
+constexpr uint64_t relative_rank_mask(int rank) {
+    return 0xFFULL << (8 * (Us == WHITE ? rank : 7 - rank));
 }
 
+template<Color Us>
+constexpr uint64_t shift_forward(uint64_t squares) {
+    return Us == WHITE ? squares << 8 : squares >> 8;
+}
+
+// Forward and towards the a-file
+template<Color Us>
+constexpr uint64_t shift_forward_left(uint64_t squares) {
+    return Us == WHITE ? (squares & 0xFEFEFEFEFEFEFEFEULL) << 7 : (squares & 0xFEFEFEFEFEFEFEFEULL) >> 9;
+}
+
+// Forward and towards the h-file
+template<Color Us>
+constexpr uint64_t shift_forward_right(uint64_t squares) {
+    return Us == WHITE ? (squares & 0x7F7F7F7F7F7F7F7FULL) << 9 : (squares & 0x7F7F7F7F7F7F7F7FULL) >> 7;
+}
+
+template<Color Us> constexpr int forward_offset() { return Us == WHITE ? 8 : -8; }
+template<Color Us> constexpr int forward_left_offset() { return Us == WHITE ? 7 : -9; }
+template<Color Us> constexpr int forward_right_offset() { return Us == WHITE ? 9 : -7; }
+
+struct PawnTargets {
+    uint64_t squares;
+    int offset;
+    MoveType type;
+};
+
 Board::Board() {
     clear_board();
     load_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    init_attack_tables();
+    MagicBitboards::init();
 }
 
-Board::Board(const std::string& fen_string) {
-    clear_board();
-    load_fen(fen_string);
+std::optional<Board> Board::from_fen(std::string_view fen_string, FenError* error) {
+    Board board;
+    FenError result = board.load_fen(fen_string);
+    if (error) {
+        *error = result;
+    }
+    if (result != FenError::NONE) {
+        return std::nullopt;
+    }
+    return board;
 }
 
 void Board::clear_board() {
@@ -67,58 +85,216 @@ void Board::clear_board() {
     white_pieces = 0ULL;
     black_pieces = 0ULL;
     all_pieces = 0ULL;
+    for (int square = 0; square < 64; square++) {
+        piece_on[square] = NO_PIECE;
+    }
     side_to_move = true;
     en_passant_square = -1;
     castling_rights = 0;
+    halfmove_clock = 0;
+    fullmove_number = 1;
+    hash_key = 0ULL;
+    history = nullptr;
 }
 
-void Board::load_fen(const std::string& fen_string) {
-    clear_board();
+// Splits off the next space-separated field without copying
+static std::string_view next_fen_field(std::string_view fen, size_t& pos) {
+    while (pos < fen.size() && (fen[pos] == ' ' || fen[pos] == '\t')) {
+        pos++;
+    }
     
-    std::istringstream fen_stream(fen_string);
-    std::string board_position, active_color, castling, en_passant, halfmove, fullmove;
+    size_t start = pos;
+    while (pos < fen.size() && fen[pos] != ' ' && fen[pos] != '\t') {
+        pos++;
+    }
+    
+    return fen.substr(start, pos - start);
+}
+
+// At most 16 men a side, pawns off the back ranks, and no more extra pieces than pawns that
+// could have promoted; this also bounds the sliders any per-position buffer has to hold
+static bool has_reachable_piece_counts(const uint64_t (&pieces)[12]) {
+    const uint64_t back_ranks = 0xFF000000000000FFULL;
+    if ((pieces[WP] | pieces[BP]) & back_ranks) {
+        return false;
+    }
     
-    fen_stream >> board_position >> active_color >> castling >> en_passant >> halfmove >> fullmove;
+    for (int base : {WP, BP}) {
+        int pawns = __builtin_popcountll(pieces[base + WP]);
+        int promoted = std::max(0, __builtin_popcountll(pieces[base + WN]) - 2) +
+                       std::max(0, __builtin_popcountll(pieces[base + WB]) - 2) +
+                       std::max(0, __builtin_popcountll(pieces[base + WR]) - 2) +
+                       std::max(0, __builtin_popcountll(pieces[base + WQ]) - 1);
+        if (pawns > 8 || pawns + promoted > 8) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_fen_counter(std::string_view field, int min_value, int& value) {
+    const char* end = field.data() + field.size();
+    auto result = std::from_chars(field.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end && value >= min_value;
+}
+
+FenError Board::load_fen(std::string_view fen_string) {
+    size_t pos = 0;
+    std::string_view placement = next_fen_field(fen_string, pos);
+    std::string_view active_color = next_fen_field(fen_string, pos);
+    std::string_view castling = next_fen_field(fen_string, pos);
+    std::string_view en_passant = next_fen_field(fen_string, pos);
+    std::string_view halfmove = next_fen_field(fen_string, pos);
+    std::string_view fullmove = next_fen_field(fen_string, pos);
     
+    // Parse into locals first so a malformed FEN never leaves a half-written board
+    uint64_t pieces[12] = {0};
+    Piece mailbox[64];
+    for (int square = 0; square < 64; square++) {
+        mailbox[square] = NO_PIECE;
+    }
     int rank = 7;
     int file = 0;
     
-    for (char c : board_position) {
+    for (char c : placement) {
         if (c == '/') {
+            if (file != 8 || rank == 0) return FenError::BAD_PIECE_PLACEMENT;
             rank--;
             file = 0;
         } else if (c >= '1' && c <= '8') {
             file += (c - '0');
+            if (file > 8) return FenError::BAD_PIECE_PLACEMENT;
         } else {
-            Square square = static_cast<Square>(rank * 8 + file);
-            uint64_t square_bit = 1ULL << square;
-            
             Piece piece = char_to_piece(c);
-            bitboards[piece] |= square_bit;
-            
+            if (piece == NO_PIECE || file >= 8) return FenError::BAD_PIECE_PLACEMENT;
+            pieces[piece] |= 1ULL << (rank * 8 + file);
+            mailbox[rank * 8 + file] = piece;
             file++;
         }
     }
     
-    side_to_move = (active_color == "w");
+    if (rank != 0 || file != 8) return FenError::BAD_PIECE_PLACEMENT;
+    if (__builtin_popcountll(pieces[WK]) != 1 || __builtin_popcountll(pieces[BK]) != 1) return FenError::BAD_KING_COUNT;
+    if (!has_reachable_piece_counts(pieces)) return FenError::BAD_PIECE_COUNT;
     
-    castling_rights = 0;
-    for (char c : castling) {
-        switch (c) {
-            case 'K': castling_rights |= 1; break;
-            case 'Q': castling_rights |= 2; break;
-            case 'k': castling_rights |= 4; break;
-            case 'q': castling_rights |= 8; break;
+    if (active_color != "w" && active_color != "b") return FenError::BAD_SIDE_TO_MOVE;
+    
+    bool white_to_move = (active_color == "w");
+    
+    // Each right needs its king and rook still on their home squares
+    int rights = 0;
+    if (castling != "-") {
+        if (castling.empty()) return FenError::BAD_CASTLING;
+        for (char c : castling) {
+            switch (c) {
+                case 'K': rights |= 1; break;
+                case 'Q': rights |= 2; break;
+                case 'k': rights |= 4; break;
+                case 'q': rights |= 8; break;
+                default: return FenError::BAD_CASTLING;
+            }
         }
     }
+    if (((rights & 3) && mailbox[E1] != WK) || ((rights & 12) && mailbox[E8] != BK) ||
+        ((rights & 1) && mailbox[H1] != WR) || ((rights & 2) && mailbox[A1] != WR) ||
+        ((rights & 4) && mailbox[H8] != BR) || ((rights & 8) && mailbox[A8] != BR)) {
+        return FenError::BAD_CASTLING;
+    }
     
+    // The square a pawn of the side that just moved skipped: empty, with the pawn right past it
+    int ep_square = -1;
     if (en_passant != "-") {
-        en_passant_square = static_cast<int>(string_to_square(en_passant));
-    } else {
-        en_passant_square = -1;
+        if (en_passant.size() != 2 || en_passant[0] < 'a' || en_passant[0] > 'h' ||
+            en_passant[1] != (white_to_move ? '6' : '3')) {
+            return FenError::BAD_EN_PASSANT;
+        }
+        ep_square = static_cast<int>(string_to_square(en_passant));
+        int pawn_square = white_to_move ? ep_square - 8 : ep_square + 8;
+        int start_square = white_to_move ? ep_square + 8 : ep_square - 8;
+        if (mailbox[pawn_square] != (white_to_move ? BP : WP) || mailbox[ep_square] != NO_PIECE ||
+            mailbox[start_square] != NO_PIECE) {
+            return FenError::BAD_EN_PASSANT;
+        }
+        
+        // Like make_move, keep the square only when a pawn can actually take on it, so the
+        // same position reached by moves or from a FEN gets the same hash key
+        if (!(pawn_attacks[white_to_move ? BLACK : WHITE][ep_square] & pieces[white_to_move ? WP : BP])) {
+            ep_square = -1;
+        }
     }
     
+    // Move counters are optional (EPD-style records omit them)
+    int halfmoves = 0;
+    int fullmoves = 1;
+    if (!halfmove.empty() && !parse_fen_counter(halfmove, 0, halfmoves)) return FenError::BAD_MOVE_COUNTERS;
+    if (!fullmove.empty() && !parse_fen_counter(fullmove, 1, fullmoves)) return FenError::BAD_MOVE_COUNTERS;
+    
+    for (int i = 0; i < 12; i++) {
+        bitboards[i] = pieces[i];
+    }
+    for (int square = 0; square < 64; square++) {
+        piece_on[square] = mailbox[square];
+    }
+    side_to_move = white_to_move;
+    castling_rights = rights;
+    en_passant_square = ep_square;
+    halfmove_clock = halfmoves;
+    fullmove_number = fullmoves;
+    history = nullptr;
+    
     update_occupancy();
+    hash_key = compute_hash_key();
+    
+    return FenError::NONE;
+}
+
+size_t Board::load_fen_batch(std::string_view buffer, Board* boards, size_t capacity, size_t* rejected) {
+    size_t loaded = 0;
+    size_t failed = 0;
+    size_t pos = 0;
+    
+    while (pos < buffer.size() && loaded < capacity) {
+        size_t end = buffer.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = buffer.size();
+        }
+        
+        std::string_view line = buffer.substr(pos, end - pos);
+        pos = end + 1;
+        
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.find_first_not_of(" \t") == std::string_view::npos) {
+            continue;
+        }
+        
+        if (boards[loaded].load_fen(line) == FenError::NONE) {
+            loaded++;
+        } else {
+            failed++;
+        }
+    }
+    
+    if (rejected) {
+        *rejected = failed;
+    }
+    
+    return loaded;
+}
+
+const char* Board::fen_error_message(FenError error) {
+    switch (error) {
+        case FenError::NONE: return "no error";
+        case FenError::BAD_PIECE_PLACEMENT: return "malformed piece placement";
+        case FenError::BAD_KING_COUNT: return "each side needs exactly one king";
+        case FenError::BAD_PIECE_COUNT: return "impossible piece counts or pawns on a back rank";
+        case FenError::BAD_SIDE_TO_MOVE: return "side to move must be 'w' or 'b'";
+        case FenError::BAD_CASTLING: return "malformed castling rights";
+        case FenError::BAD_EN_PASSANT: return "malformed en passant square";
+        case FenError::BAD_MOVE_COUNTERS: return "malformed halfmove/fullmove counters";
+        default: return "unknown error";
+    }
 }
 
 std::string Board::to_fen_string() const {
@@ -127,20 +303,9 @@ std::string Board::to_fen_string() const {
     for (int rank = 7; rank >= 0; rank--) {
         int empty_count = 0;
         for (int file = 0; file < 8; file++) {
-            Square square = static_cast<Square>(rank * 8 + file);
-            uint64_t square_bit = 1ULL << square;
+            Piece piece = piece_on[rank * 8 + file];
             
-            Piece piece = WP;
-            bool found = false;
-            for (int p = WP; p <= BK; p++) {
-                if (bitboards[p] & square_bit) {
-                    piece = static_cast<Piece>(p);
-                    found = true;
-                    break;
-                }
-            }
-            
-            if (found) {
+            if (piece != NO_PIECE) {
                 if (empty_count > 0) {
                     fen += std::to_string(empty_count);
                     empty_count = 0;
@@ -179,12 +344,27 @@ std::string Board::to_fen_string() const {
         fen += "-";
     }
     
-    fen += " 0 1";
+    fen += " " + std::to_string(halfmove_clock) + " " + std::to_string(fullmove_number);
     
     return fen;
 }
 
+std::string Board::move_to_string(const Move& move) {
+    std::string result;
+    result += static_cast<char>('a' + move.from() % 8);
+    result += static_cast<char>('1' + move.from() / 8);
+    result += static_cast<char>('a' + move.to() % 8);
+    result += static_cast<char>('1' + move.to() / 8);
+    
+    if (move.type() == PROMOTION) {
+        result += static_cast<char>(piece_to_char(move.promotion_piece()) | 0x20);
+    }
+    
+    return result;
+}
+
 void Board::update_occupancy() {
+    attack_cache_valid = false;
     white_pieces = 0ULL;
     black_pieces = 0ULL;
     
@@ -199,147 +379,272 @@ void Board::update_occupancy() {
     all_pieces = white_pieces | black_pieces;
 }
 
-void Board::generate_pawn_moves(MoveList& move_list) {
-    if (side_to_move) {
-        uint64_t pawns = bitboards[WP];
-        uint64_t empty = ~all_pieces;
-        uint64_t enemy_pieces = black_pieces;
-        
-        uint64_t single_pushes = (pawns << 8) & empty;
-        uint64_t double_pushes = ((single_pushes & 0xFF0000ULL) << 8) & empty;
-        
-        uint64_t left_captures = ((pawns & 0xFEFEFEFEFEFEFEFEULL) << 7) & enemy_pieces;
-        uint64_t right_captures = ((pawns & 0x7F7F7F7F7F7F7F7FULL) << 9) & enemy_pieces;
-        
-        while (single_pushes) {
-            int to = __builtin_ctzll(single_pushes);
-            int from = to - 8;
-            if (to >= 56) {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WQ));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WR));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WB));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WN));
-            } else {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), NORMAL));
-            }
-            single_pushes &= single_pushes - 1;
-        }
-        
-        while (double_pushes) {
-            int to = __builtin_ctzll(double_pushes);
-            int from = to - 16;
-            move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), NORMAL));
-            double_pushes &= double_pushes - 1;
-        }
-        
-        while (left_captures) {
-            int to = __builtin_ctzll(left_captures);
-            int from = to - 7;
-            if (to >= 56) {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WQ));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WR));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WB));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WN));
-            } else {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), CAPTURE));
-            }
-            left_captures &= left_captures - 1;
-        }
-        
-        while (right_captures) {
-            int to = __builtin_ctzll(right_captures);
-            int from = to - 9;
-            if (to >= 56) {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WQ));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WR));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WB));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, WN));
-            } else {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), CAPTURE));
-            }
-            right_captures &= right_captures - 1;
-        }
-        
-        if (en_passant_square != -1) {
-            uint64_t ep_pawns = pawns & ((1ULL << (en_passant_square - 7)) | (1ULL << (en_passant_square - 9)));
-            while (ep_pawns) {
-                int from = __builtin_ctzll(ep_pawns);
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(en_passant_square), EN_PASSANT));
-                ep_pawns &= ep_pawns - 1;
-            }
+uint64_t Board::compute_hash_key() const {
+    uint64_t key = 0ULL;
+    
+    for (int p = WP; p <= BK; p++) {
+        uint64_t pieces = bitboards[p];
+        while (pieces) {
+            key ^= ZOBRIST.pieces[p][__builtin_ctzll(pieces)];
+            pieces &= pieces - 1;
         }
-    } else {
-        uint64_t pawns = bitboards[BP];
-        uint64_t empty = ~all_pieces;
-        uint64_t enemy_pieces = white_pieces;
-        
-        uint64_t single_pushes = (pawns >> 8) & empty;
-        uint64_t double_pushes = ((single_pushes & 0xFF000000000000ULL) >> 8) & empty;
-        
-        uint64_t left_captures = ((pawns & 0x7F7F7F7F7F7F7F7FULL) >> 7) & enemy_pieces;
-        uint64_t right_captures = ((pawns & 0xFEFEFEFEFEFEFEFEULL) >> 9) & enemy_pieces;
-        
-        while (single_pushes) {
-            int to = __builtin_ctzll(single_pushes);
-            int from = to + 8;
-            if (to <= 7) {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BQ));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BR));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BB));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BN));
-            } else {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), NORMAL));
-            }
-            single_pushes &= single_pushes - 1;
+    }
+    
+    if (!side_to_move) {
+        key ^= ZOBRIST.side;
+    }
+    
+    key ^= ZOBRIST.castling[castling_rights];
+    
+    if (en_passant_square != -1) {
+        key ^= ZOBRIST.en_passant_file[en_passant_square % 8];
+    }
+    
+    return key;
+}
+
+Piece Board::piece_at(Square square) const {
+    return piece_on[square];
+}
+
+void Board::make_move(const Move& move, UndoInfo& undo) {
+    attack_cache_valid = false;
+    undo.previous = history;
+    history = &undo;
+    undo.move = move;
+    undo.en_passant_square = en_passant_square;
+    undo.castling_rights = castling_rights;
+    undo.halfmove_clock = halfmove_clock;
+    undo.hash_key = hash_key;
+    
+    uint64_t from_bit = 1ULL << move.from();
+    uint64_t to_bit = 1ULL << move.to();
+    uint64_t from_to = from_bit | to_bit;
+    
+    uint64_t& friendly_pieces = side_to_move ? white_pieces : black_pieces;
+    uint64_t& enemy_pieces = side_to_move ? black_pieces : white_pieces;
+    
+    Piece moved = piece_on[move.from()];
+    Piece captured = piece_on[move.to()];
+    
+    if (move.type() == EN_PASSANT) {
+        int captured_square = side_to_move ? move.to() - 8 : move.to() + 8;
+        uint64_t captured_bit = 1ULL << captured_square;
+        captured = side_to_move ? BP : WP;
+        bitboards[captured] ^= captured_bit;
+        enemy_pieces ^= captured_bit;
+        piece_on[captured_square] = NO_PIECE;
+        hash_key ^= ZOBRIST.pieces[captured][captured_square];
+    } else if (captured != NO_PIECE) {
+        bitboards[captured] ^= to_bit;
+        enemy_pieces ^= to_bit;
+        hash_key ^= ZOBRIST.pieces[captured][move.to()];
+    }
+    
+    bitboards[moved] ^= from_to;
+    friendly_pieces ^= from_to;
+    piece_on[move.from()] = NO_PIECE;
+    piece_on[move.to()] = moved;
+    hash_key ^= ZOBRIST.pieces[moved][move.from()] ^ ZOBRIST.pieces[moved][move.to()];
+    
+    if (move.type() == PROMOTION) {
+        bitboards[moved] ^= to_bit;
+        bitboards[move.promotion_piece()] ^= to_bit;
+        piece_on[move.to()] = move.promotion_piece();
+        hash_key ^= ZOBRIST.pieces[moved][move.to()] ^ ZOBRIST.pieces[move.promotion_piece()][move.to()];
+    } else if (move.type() == CASTLE_KING || move.type() == CASTLE_QUEEN) {
+        // Rook jumps from the corner to the square the king passed over
+        int rook_from = move.type() == CASTLE_KING ? move.to() + 1 : move.to() - 2;
+        int rook_to = move.type() == CASTLE_KING ? move.to() - 1 : move.to() + 1;
+        uint64_t rook_from_to = (1ULL << rook_from) | (1ULL << rook_to);
+        Piece rook = side_to_move ? WR : BR;
+        bitboards[rook] ^= rook_from_to;
+        friendly_pieces ^= rook_from_to;
+        piece_on[rook_from] = NO_PIECE;
+        piece_on[rook_to] = rook;
+        hash_key ^= ZOBRIST.pieces[rook][rook_from] ^ ZOBRIST.pieces[rook][rook_to];
+    }
+    
+    all_pieces = white_pieces | black_pieces;
+    
+    hash_key ^= ZOBRIST.castling[castling_rights];
+    castling_rights &= castling_rights_mask[move.from()] & castling_rights_mask[move.to()];
+    hash_key ^= ZOBRIST.castling[castling_rights];
+    
+    // Only record an en passant square when an enemy pawn can actually take it
+    if (en_passant_square != -1) {
+        hash_key ^= ZOBRIST.en_passant_file[en_passant_square % 8];
+    }
+    en_passant_square = -1;
+    if ((moved == WP || moved == BP) && (move.to() ^ move.from()) == 16) {
+        int skipped_square = (move.from() + move.to()) / 2;
+        if (pawn_attacks[side_to_move ? 0 : 1][skipped_square] & bitboards[side_to_move ? BP : WP]) {
+            en_passant_square = skipped_square;
+            hash_key ^= ZOBRIST.en_passant_file[en_passant_square % 8];
         }
-        
-        while (double_pushes) {
-            int to = __builtin_ctzll(double_pushes);
-            int from = to + 16;
-            move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), NORMAL));
-            double_pushes &= double_pushes - 1;
+    }
+    
+    undo.moved_piece = moved;
+    undo.captured_piece = captured;
+    
+    halfmove_clock = (moved == WP || moved == BP || captured != NO_PIECE) ? 0 : halfmove_clock + 1;
+    if (!side_to_move) {
+        fullmove_number++;
+    }
+    
+    side_to_move = !side_to_move;
+    hash_key ^= ZOBRIST.side;
+}
+
+void Board::unmake_move() {
+    attack_cache_valid = false;
+    const UndoInfo& undo = *history;
+    history = undo.previous;
+    const Move& move = undo.move;
+    
+    side_to_move = !side_to_move;
+    en_passant_square = undo.en_passant_square;
+    castling_rights = undo.castling_rights;
+    halfmove_clock = undo.halfmove_clock;
+    hash_key = undo.hash_key;
+    if (!side_to_move) {
+        fullmove_number--;
+    }
+    
+    uint64_t from_bit = 1ULL << move.from();
+    uint64_t to_bit = 1ULL << move.to();
+    uint64_t from_to = from_bit | to_bit;
+    
+    uint64_t& friendly_pieces = side_to_move ? white_pieces : black_pieces;
+    uint64_t& enemy_pieces = side_to_move ? black_pieces : white_pieces;
+    
+    if (move.type() == PROMOTION) {
+        bitboards[move.promotion_piece()] ^= to_bit;
+        bitboards[undo.moved_piece] ^= to_bit;
+    } else if (move.type() == CASTLE_KING || move.type() == CASTLE_QUEEN) {
+        int rook_from = move.type() == CASTLE_KING ? move.to() + 1 : move.to() - 2;
+        int rook_to = move.type() == CASTLE_KING ? move.to() - 1 : move.to() + 1;
+        uint64_t rook_from_to = (1ULL << rook_from) | (1ULL << rook_to);
+        Piece rook = side_to_move ? WR : BR;
+        bitboards[rook] ^= rook_from_to;
+        friendly_pieces ^= rook_from_to;
+        piece_on[rook_to] = NO_PIECE;
+        piece_on[rook_from] = rook;
+    }
+    
+    bitboards[undo.moved_piece] ^= from_to;
+    friendly_pieces ^= from_to;
+    piece_on[move.from()] = undo.moved_piece;
+    piece_on[move.to()] = NO_PIECE;
+    
+    if (undo.captured_piece != NO_PIECE) {
+        int captured_square = move.to();
+        if (move.type() == EN_PASSANT) {
+            captured_square = side_to_move ? move.to() - 8 : move.to() + 8;
         }
-        
-        while (left_captures) {
-            int to = __builtin_ctzll(left_captures);
-            int from = to + 7;
-            if (to <= 7) {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BQ));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BR));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BB));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BN));
-            } else {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), CAPTURE));
-            }
-            left_captures &= left_captures - 1;
+        bitboards[undo.captured_piece] ^= 1ULL << captured_square;
+        enemy_pieces ^= 1ULL << captured_square;
+        piece_on[captured_square] = undo.captured_piece;
+    }
+    
+    all_pieces = white_pieces | black_pieces;
+}
+
+void Board::make_null_move(UndoInfo& undo) {
+    attack_cache_valid = false;
+    undo.previous = history;
+    history = &undo;
+    undo.move = Move();
+    undo.moved_piece = NO_PIECE;
+    undo.captured_piece = NO_PIECE;
+    undo.en_passant_square = en_passant_square;
+    undo.castling_rights = castling_rights;
+    undo.halfmove_clock = halfmove_clock;
+    undo.hash_key = hash_key;
+    
+    if (en_passant_square != -1) {
+        hash_key ^= ZOBRIST.en_passant_file[en_passant_square % 8];
+    }
+    en_passant_square = -1;
+    
+    // Positions before a null move are unreachable by real moves, so stop repetition scans here
+    halfmove_clock = 0;
+    side_to_move = !side_to_move;
+    hash_key ^= ZOBRIST.side;
+}
+
+void Board::unmake_null_move() {
+    attack_cache_valid = false;
+    const UndoInfo& undo = *history;
+    history = undo.previous;
+    
+    side_to_move = !side_to_move;
+    en_passant_square = undo.en_passant_square;
+    halfmove_clock = undo.halfmove_clock;
+    hash_key = undo.hash_key;
+}
+
+bool Board::is_repetition() const {
+    // Only positions since the last irreversible move can recur, and only with the same side
+    // to move. The record made n plies ago holds the key of the position n plies back.
+    const UndoInfo* undo = history;
+    for (int plies = 1; undo && plies <= halfmove_clock; plies++, undo = undo->previous) {
+        if (plies >= 4 && plies % 2 == 0 && undo->hash_key == hash_key) {
+            return true;
         }
+    }
+    return false;
+}
+
+template<Color Us>
+void Board::generate_pawn_moves(MoveList& move_list) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    uint64_t pawns = bitboards[relative_piece<Us>(WP)];
+    uint64_t empty = ~all_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
+    
+    uint64_t single_pushes = shift_forward<Us>(pawns) & empty;
+    uint64_t double_pushes = shift_forward<Us>(single_pushes & relative_rank_mask<Us>(2)) & empty;
+    
+    const PawnTargets pawn_targets[4] = {
+        {single_pushes, forward_offset<Us>(), NORMAL},
+        {double_pushes, 2 * forward_offset<Us>(), NORMAL},
+        {shift_forward_left<Us>(pawns) & enemy_pieces, forward_left_offset<Us>(), CAPTURE},
+        {shift_forward_right<Us>(pawns) & enemy_pieces, forward_right_offset<Us>(), CAPTURE}
+    };
+    
+    for (const PawnTargets& group : pawn_targets) {
+        uint64_t squares = group.squares;
         
-        while (right_captures) {
-            int to = __builtin_ctzll(right_captures);
-            int from = to + 9;
-            if (to <= 7) {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BQ));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BR));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BB));
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), PROMOTION, BN));
+        while (squares) {
+            Square to = static_cast<Square>(__builtin_ctzll(squares));
+            Square from = static_cast<Square>(to - group.offset);
+            
+            if ((1ULL << to) & relative_rank_mask<Us>(7)) {
+                add_promotions<Us>(move_list, from, to);
             } else {
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(to), CAPTURE));
+                move_list.push_back(Move(from, to, group.type));
             }
-            right_captures &= right_captures - 1;
+            squares &= squares - 1;
         }
-        
-        if (en_passant_square != -1) {
-            uint64_t ep_pawns = pawns & ((1ULL << (en_passant_square + 7)) | (1ULL << (en_passant_square + 9)));
-            while (ep_pawns) {
-                int from = __builtin_ctzll(ep_pawns);
-                move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(en_passant_square), EN_PASSANT));
-                ep_pawns &= ep_pawns - 1;
-            }
+    }
+    
+    if (en_passant_square != -1) {
+        // Our pawns that could capture onto the square are where an enemy pawn there would attack
+        uint64_t ep_pawns = pawns & pawn_attacks[Them][en_passant_square];
+        while (ep_pawns) {
+            int from = __builtin_ctzll(ep_pawns);
+            move_list.push_back(Move(static_cast<Square>(from), static_cast<Square>(en_passant_square), EN_PASSANT));
+            ep_pawns &= ep_pawns - 1;
         }
     }
 }
 
-Square Board::string_to_square(const std::string& square_str) {
+void Board::generate_pawn_moves(MoveList& move_list) {
+    side_to_move ? generate_pawn_moves<WHITE>(move_list) : generate_pawn_moves<BLACK>(move_list);
+}
+
+Square Board::string_to_square(std::string_view square_str) {
     if (square_str.length() != 2) return A1;
     
     int file = square_str[0] - 'a';
@@ -380,14 +685,15 @@ Piece Board::char_to_piece(char c) {
         case 'r': return BR;
         case 'q': return BQ;
         case 'k': return BK;
-        default: return WP;
+        default: return NO_PIECE;
     }
 }
 
+template<Color Us>
 void Board::generate_knight_moves(MoveList& move_list) {
-    uint64_t knights = side_to_move ? bitboards[WN] : bitboards[BN];
-    uint64_t friendly_pieces = side_to_move ? white_pieces : black_pieces;
-    uint64_t enemy_pieces = side_to_move ? black_pieces : white_pieces;
+    uint64_t knights = bitboards[relative_piece<Us>(WN)];
+    uint64_t friendly_pieces = Us == WHITE ? white_pieces : black_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
     
     while (knights) {
         int from = __builtin_ctzll(knights);
@@ -404,37 +710,26 @@ void Board::generate_knight_moves(MoveList& move_list) {
     }
 }
 
+void Board::generate_knight_moves(MoveList& move_list) {
+    side_to_move ? generate_knight_moves<WHITE>(move_list) : generate_knight_moves<BLACK>(move_list);
+}
+
 bool Board::is_square_attacked(Square square, bool by_white) const {
-    uint64_t square_bit = 1ULL << square;
-    uint64_t attackers = by_white ? white_pieces : black_pieces;
-    
-    if (by_white) {
-        if ((bitboards[WP] & ((square_bit >> 7) & 0xFEFEFEFEFEFEFEFEULL)) ||
-            (bitboards[WP] & ((square_bit >> 9) & 0x7F7F7F7F7F7F7F7FULL))) {
-            return true;
-        }
-    } else {
-        if ((bitboards[BP] & ((square_bit << 7) & 0x7F7F7F7F7F7F7F7FULL)) ||
-            (bitboards[BP] & ((square_bit << 9) & 0xFEFEFEFEFEFEFEFEULL))) {
-            return true;
-        }
-    }
-    
-    if (knight_attacks[square] & (by_white ? bitboards[WN] : bitboards[BN])) {
-        return true;
-    }
-    
-    if (king_attacks[square] & (by_white ? bitboards[WK] : bitboards[BK])) {
-        return true;
-    }
-    
-    return false;
+    uint64_t attackers = by_white ? attackers_of<WHITE>(square, all_pieces) : attackers_of<BLACK>(square, all_pieces);
+    return attackers != 0ULL;
 }
 
+template<Color Us>
 void Board::generate_king_moves(MoveList& move_list) {
-    uint64_t king = side_to_move ? bitboards[WK] : bitboards[BK];
-    uint64_t friendly_pieces = side_to_move ? white_pieces : black_pieces;
-    uint64_t enemy_pieces = side_to_move ? black_pieces : white_pieces;
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int king_side = Us == WHITE ? 1 : 4;
+    constexpr int queen_side = Us == WHITE ? 2 : 8;
+    constexpr Square king_start = Us == WHITE ? E1 : E8;
+    constexpr uint64_t king_side_path = Us == WHITE ? 0x60ULL : 0x6000000000000000ULL;
+    constexpr uint64_t queen_side_path = Us == WHITE ? 0x0EULL : 0x0E00000000000000ULL;
+    uint64_t king = bitboards[relative_piece<Us>(WK)];
+    uint64_t friendly_pieces = Us == WHITE ? white_pieces : black_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
     
     if (king) {
         int from = __builtin_ctzll(king);
@@ -447,43 +742,34 @@ void Board::generate_king_moves(MoveList& move_list) {
             attacks &= attacks - 1;
         }
         
-        if (side_to_move) {
-            if ((castling_rights & 1) && // White king-side castling right
-                !(all_pieces & 0x60ULL) && // Check if squares between king and rook are empty
-                !is_square_attacked(F1, false) && // Check if F1 is not under attack
-                !is_square_attacked(G1, false)) { // Check if G1 is not under attack
-                move_list.push_back(Move(E1, G1, CASTLE_KING));
-            }
-            
-            if ((castling_rights & 2) && // White queen-side castling right
-                !(all_pieces & 0x0EULL) && // Check if squares between king and rook are empty
-                !is_square_attacked(D1, false) && // Check if D1 is not under attack
-                !is_square_attacked(C1, false)) { // Check if C1 is not under attack
-                move_list.push_back(Move(E1, C1, CASTLE_QUEEN));
-            }
-        } else {
-            if ((castling_rights & 4) && // Black king-side castling right
-                !(all_pieces & 0x6000000000000000ULL) && // Check if squares between king and rook are empty
-                !is_square_attacked(F8, true) && // Check if F8 is not under attack
-                !is_square_attacked(G8, true)) { // Check if G8 is not under attack
-                move_list.push_back(Move(E8, G8, CASTLE_KING));
-            }
-            
-            if ((castling_rights & 8) && // Black queen-side castling right
-                !(all_pieces & 0x0E00000000000000ULL) && // Check if squares between king and rook are empty
-                !is_square_attacked(D8, true) && // Check if D8 is not under attack
-                !is_square_attacked(C8, true)) { // Check if C8 is not under attack
-                move_list.push_back(Move(E8, C8, CASTLE_QUEEN));
-            }
+        if ((castling_rights & king_side) && // King-side castling right
+            !(all_pieces & king_side_path) && // Check if squares between king and rook are empty
+            !attackers_of<Them>(king_start, all_pieces) && // Check if the king is not in check
+            !attackers_of<Them>(static_cast<Square>(king_start + 1), all_pieces) && // Check if F1/F8 is not under attack
+            !attackers_of<Them>(static_cast<Square>(king_start + 2), all_pieces)) { // Check if G1/G8 is not under attack
+            move_list.push_back(Move(king_start, static_cast<Square>(king_start + 2), CASTLE_KING));
+        }
+        
+        if ((castling_rights & queen_side) && // Queen-side castling right
+            !(all_pieces & queen_side_path) && // Check if squares between king and rook are empty
+            !attackers_of<Them>(king_start, all_pieces) && // Check if the king is not in check
+            !attackers_of<Them>(static_cast<Square>(king_start - 1), all_pieces) && // Check if D1/D8 is not under attack
+            !attackers_of<Them>(static_cast<Square>(king_start - 2), all_pieces)) { // Check if C1/C8 is not under attack
+            move_list.push_back(Move(king_start, static_cast<Square>(king_start - 2), CASTLE_QUEEN));
         }
     }
 }
 
+void Board::generate_king_moves(MoveList& move_list) {
+    side_to_move ? generate_king_moves<WHITE>(move_list) : generate_king_moves<BLACK>(move_list);
+}
+
+template<Color Us>
 void Board::generate_sliding_moves(MoveList& move_list) {
-    uint64_t friendly_pieces = side_to_move ? white_pieces : black_pieces;
-    uint64_t enemy_pieces = side_to_move ? black_pieces : white_pieces;
+    uint64_t friendly_pieces = Us == WHITE ? white_pieces : black_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
     
-    uint64_t rooks = side_to_move ? bitboards[WR] : bitboards[BR];
+    uint64_t rooks = bitboards[relative_piece<Us>(WR)];
     while (rooks) {
         int from = __builtin_ctzll(rooks);
         uint64_t attacks = MagicBitboards::get_rook_attacks(from, all_pieces) & ~friendly_pieces;
@@ -498,7 +784,7 @@ void Board::generate_sliding_moves(MoveList& move_list) {
         rooks &= rooks - 1;
     }
     
-    uint64_t bishops = side_to_move ? bitboards[WB] : bitboards[BB];
+    uint64_t bishops = bitboards[relative_piece<Us>(WB)];
     while (bishops) {
         int from = __builtin_ctzll(bishops);
         uint64_t attacks = MagicBitboards::get_bishop_attacks(from, all_pieces) & ~friendly_pieces;
@@ -513,7 +799,7 @@ void Board::generate_sliding_moves(MoveList& move_list) {
         bishops &= bishops - 1;
     }
     
-    uint64_t queens = side_to_move ? bitboards[WQ] : bitboards[BQ];
+    uint64_t queens = bitboards[relative_piece<Us>(WQ)];
     while (queens) {
         int from = __builtin_ctzll(queens);
         uint64_t rook_attacks = MagicBitboards::get_rook_attacks(from, all_pieces);
@@ -529,4 +815,556 @@ void Board::generate_sliding_moves(MoveList& move_list) {
         
         queens &= queens - 1;
     }
-} 
\ No newline at end of file
+}
+
+void Board::generate_sliding_moves(MoveList& move_list) {
+    side_to_move ? generate_sliding_moves<WHITE>(move_list) : generate_sliding_moves<BLACK>(move_list);
+}
+
+template<Color Them>
+uint64_t Board::attackers_of(Square square, uint64_t occupancy) const {
+    constexpr Color Us = Them == WHITE ? BLACK : WHITE;
+    uint64_t attackers = 0ULL;
+    
+    // Their pawns attack this square from wherever one of our pawns here would attack
+    attackers |= pawn_attacks[Us][square] & bitboards[relative_piece<Them>(WP)];
+    
+    uint64_t queens = bitboards[relative_piece<Them>(WQ)];
+    uint64_t rooks = bitboards[relative_piece<Them>(WR)] | queens;
+    uint64_t bishops = bitboards[relative_piece<Them>(WB)] | queens;
+    
+    attackers |= knight_attacks[square] & bitboards[relative_piece<Them>(WN)];
+    attackers |= king_attacks[square] & bitboards[relative_piece<Them>(WK)];
+    attackers |= MagicBitboards::get_rook_attacks(square, occupancy) & rooks;
+    attackers |= MagicBitboards::get_bishop_attacks(square, occupancy) & bishops;
+    
+    return attackers;
+}
+
+uint64_t Board::slider_attacks(bool white) const {
+    uint64_t queens = white ? bitboards[WQ] : bitboards[BQ];
+    uint64_t orthogonal = (white ? bitboards[WR] : bitboards[BR]) | queens;
+    uint64_t diagonal = (white ? bitboards[WB] : bitboards[BB]) | queens;
+    
+    return KoggeStone::slider_attacks(orthogonal, diagonal, all_pieces);
+}
+
+uint64_t Board::attackers_to(Square square, uint64_t occupancy) const {
+    uint64_t rooks = bitboards[WR] | bitboards[BR] | bitboards[WQ] | bitboards[BQ];
+    uint64_t bishops = bitboards[WB] | bitboards[BB] | bitboards[WQ] | bitboards[BQ];
+    
+    return (pawn_attacks[1][square] & bitboards[WP]) |
+           (pawn_attacks[0][square] & bitboards[BP]) |
+           (knight_attacks[square] & (bitboards[WN] | bitboards[BN])) |
+           (king_attacks[square] & (bitboards[WK] | bitboards[BK])) |
+           (MagicBitboards::get_rook_attacks(square, occupancy) & rooks) |
+           (MagicBitboards::get_bishop_attacks(square, occupancy) & bishops);
+}
+
+template<Color Them>
+uint64_t Board::attacked_squares(uint64_t occupancy) const {
+    uint64_t pawns = bitboards[relative_piece<Them>(WP)];
+    uint64_t attacks = shift_forward_left<Them>(pawns) | shift_forward_right<Them>(pawns);
+    
+    uint64_t knights = bitboards[relative_piece<Them>(WN)];
+    while (knights) {
+        attacks |= knight_attacks[__builtin_ctzll(knights)];
+        knights &= knights - 1;
+    }
+    
+    attacks |= king_attacks[__builtin_ctzll(bitboards[relative_piece<Them>(WK)])];
+    
+    uint64_t queens = bitboards[relative_piece<Them>(WQ)];
+    uint64_t rooks = bitboards[relative_piece<Them>(WR)] | queens;
+    uint64_t bishops = bitboards[relative_piece<Them>(WB)] | queens;
+    while (rooks) {
+        attacks |= MagicBitboards::get_rook_attacks(__builtin_ctzll(rooks), occupancy);
+        rooks &= rooks - 1;
+    }
+    while (bishops) {
+        attacks |= MagicBitboards::get_bishop_attacks(__builtin_ctzll(bishops), occupancy);
+        bishops &= bishops - 1;
+    }
+    
+    return attacks;
+}
+
+uint64_t Board::attacked_squares(bool by_white, uint64_t occupancy) const {
+    return by_white ? attacked_squares<WHITE>(occupancy) : attacked_squares<BLACK>(occupancy);
+}
+
+template<Color Us>
+void Board::add_side_attacks(AttackMap& map) const {
+    uint64_t pawns = bitboards[relative_piece<Us>(WP)];
+    map.by_piece[relative_piece<Us>(WP)] = shift_forward_left<Us>(pawns) | shift_forward_right<Us>(pawns);
+    
+    uint64_t knight_targets = 0ULL;
+    for (uint64_t knights = bitboards[relative_piece<Us>(WN)]; knights; knights &= knights - 1) {
+        knight_targets |= knight_attacks[__builtin_ctzll(knights)];
+    }
+    map.by_piece[relative_piece<Us>(WN)] = knight_targets;
+    
+    uint64_t bishop_targets = 0ULL;
+    for (uint64_t bishops = bitboards[relative_piece<Us>(WB)]; bishops; bishops &= bishops - 1) {
+        bishop_targets |= MagicBitboards::get_bishop_attacks(__builtin_ctzll(bishops), all_pieces);
+    }
+    map.by_piece[relative_piece<Us>(WB)] = bishop_targets;
+    
+    uint64_t rook_targets = 0ULL;
+    for (uint64_t rooks = bitboards[relative_piece<Us>(WR)]; rooks; rooks &= rooks - 1) {
+        rook_targets |= MagicBitboards::get_rook_attacks(__builtin_ctzll(rooks), all_pieces);
+    }
+    map.by_piece[relative_piece<Us>(WR)] = rook_targets;
+    
+    uint64_t queen_targets = 0ULL;
+    for (uint64_t queens = bitboards[relative_piece<Us>(WQ)]; queens; queens &= queens - 1) {
+        int square = __builtin_ctzll(queens);
+        queen_targets |= MagicBitboards::get_rook_attacks(square, all_pieces) |
+                         MagicBitboards::get_bishop_attacks(square, all_pieces);
+    }
+    map.by_piece[relative_piece<Us>(WQ)] = queen_targets;
+    
+    map.by_piece[relative_piece<Us>(WK)] = king_attacks[__builtin_ctzll(bitboards[relative_piece<Us>(WK)])];
+    
+    map.by_side[Us] = map.by_piece[relative_piece<Us>(WP)] | knight_targets | bishop_targets |
+                      rook_targets | queen_targets | map.by_piece[relative_piece<Us>(WK)];
+}
+
+AttackMap Board::compute_attack_map() const {
+    AttackMap map;
+    add_side_attacks<WHITE>(map);
+    add_side_attacks<BLACK>(map);
+    
+    // Lifting the king only changes the reach of sliders that attack it through its square
+    int them = side_to_move ? BLACK : WHITE;
+    Square king_square = static_cast<Square>(__builtin_ctzll(bitboards[side_to_move ? WK : BK]));
+    uint64_t occupancy = all_pieces ^ (1ULL << king_square);
+    uint64_t queens = bitboards[them * 6 + WQ];
+    uint64_t rooks = bitboards[them * 6 + WR] | queens;
+    uint64_t bishops = bitboards[them * 6 + WB] | queens;
+    uint64_t sliding_checkers = (MagicBitboards::get_rook_attacks(king_square, all_pieces) & rooks) |
+                                (MagicBitboards::get_bishop_attacks(king_square, all_pieces) & bishops);
+    
+    map.king_danger = map.by_side[them];
+    for (; sliding_checkers; sliding_checkers &= sliding_checkers - 1) {
+        int square = __builtin_ctzll(sliding_checkers);
+        uint64_t bit = 1ULL << square;
+        if (bit & rooks) {
+            map.king_danger |= MagicBitboards::get_rook_attacks(square, occupancy);
+        }
+        if (bit & bishops) {
+            map.king_danger |= MagicBitboards::get_bishop_attacks(square, occupancy);
+        }
+    }
+    
+    return map;
+}
+
+const AttackMap& Board::attack_map() const {
+    if (!attack_cache_valid) {
+        attack_cache = compute_attack_map();
+        attack_cache_valid = true;
+    }
+    return attack_cache;
+}
+
+bool Board::in_check() const {
+    return (attack_map().by_side[side_to_move ? BLACK : WHITE] & bitboards[side_to_move ? WK : BK]) != 0ULL;
+}
+
+uint64_t Board::xray_attackers_to(Square square, uint64_t occupancy) const {
+    uint64_t rooks = bitboards[WR] | bitboards[BR] | bitboards[WQ] | bitboards[BQ];
+    uint64_t bishops = bitboards[WB] | bitboards[BB] | bitboards[WQ] | bitboards[BQ];
+    
+    // Lift the first blocker on every ray and keep only what the second lookup newly reaches
+    uint64_t rook_attacks = MagicBitboards::get_rook_attacks(square, occupancy);
+    uint64_t rook_xrays = rook_attacks ^ MagicBitboards::get_rook_attacks(square, occupancy ^ (rook_attacks & occupancy));
+    uint64_t bishop_attacks = MagicBitboards::get_bishop_attacks(square, occupancy);
+    uint64_t bishop_xrays = bishop_attacks ^ MagicBitboards::get_bishop_attacks(square, occupancy ^ (bishop_attacks & occupancy));
+    
+    return (rook_xrays & rooks) | (bishop_xrays & bishops);
+}
+
+int Board::see(const Move& move) const {
+    if (move.type() == CASTLE_KING || move.type() == CASTLE_QUEEN) {
+        return 0;
+    }
+    
+    Square from = move.from();
+    Square to = move.to();
+    uint64_t occupancy = all_pieces ^ (1ULL << from);
+    
+    // gain[d] is the material balance for the side making capture d if the exchange stopped there
+    int gain[32];
+    int depth = 0;
+    Piece on_square = piece_on[from];
+    
+    if (move.type() == EN_PASSANT) {
+        gain[0] = see_piece_value[WP];
+        occupancy ^= 1ULL << (side_to_move ? to - 8 : to + 8);
+    } else {
+        gain[0] = piece_on[to] == NO_PIECE ? 0 : see_piece_value[piece_on[to] % 6];
+    }
+    if (move.type() == PROMOTION) {
+        on_square = move.promotion_piece();
+        gain[0] += see_piece_value[on_square % 6] - see_piece_value[WP];
+    }
+    
+    uint64_t attackers = attackers_to(to, occupancy) & occupancy;
+    bool white = !side_to_move;
+    
+    while (depth < 31) {
+        uint64_t side_attackers = attackers & (white ? white_pieces : black_pieces);
+        if (!side_attackers) {
+            break;
+        }
+        
+        // Always recapture with the least valuable piece
+        int attacker = white ? WP : BP;
+        while (!(side_attackers & bitboards[attacker])) {
+            attacker++;
+        }
+        
+        // A king may only recapture if nothing can take it back
+        if (attacker % 6 == WK && (attackers & (white ? black_pieces : white_pieces))) {
+            break;
+        }
+        
+        depth++;
+        gain[depth] = see_piece_value[on_square % 6] - gain[depth - 1];
+        
+        int capturer = __builtin_ctzll(side_attackers & bitboards[attacker]);
+        
+        // Removing the piece may uncover a slider behind it on the same line
+        if (attacker % 6 != WN && attacker % 6 != WK) {
+            for (uint64_t xrays = xray_attackers_to(to, occupancy); xrays; xrays &= xrays - 1) {
+                int square = __builtin_ctzll(xrays);
+                if (between[to][square] & (1ULL << capturer)) {
+                    attackers |= 1ULL << square;
+                }
+            }
+        }
+        occupancy ^= 1ULL << capturer;
+        attackers &= occupancy;
+        
+        on_square = static_cast<Piece>(attacker);
+        white = !white;
+    }
+    
+    // Walk back up: each side either stops or takes, whichever leaves it better off
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    
+    return gain[0];
+}
+
+template<Color Us>
+uint64_t Board::pinned_pieces(Square king_square) const {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    uint64_t friendly_pieces = Us == WHITE ? white_pieces : black_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
+    uint64_t enemy_queens = bitboards[relative_piece<Them>(WQ)];
+    uint64_t enemy_rooks = bitboards[relative_piece<Them>(WR)] | enemy_queens;
+    uint64_t enemy_bishops = bitboards[relative_piece<Them>(WB)] | enemy_queens;
+    
+    // Look through our own pieces to find every slider lined up with the king
+    uint64_t snipers = (MagicBitboards::get_rook_attacks(king_square, enemy_pieces) & enemy_rooks) |
+                       (MagicBitboards::get_bishop_attacks(king_square, enemy_pieces) & enemy_bishops);
+    uint64_t pinned = 0ULL;
+    
+    while (snipers) {
+        Square sniper = static_cast<Square>(__builtin_ctzll(snipers));
+        uint64_t blockers = between[king_square][sniper] & all_pieces;
+        
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & friendly_pieces)) {
+            pinned |= blockers;
+        }
+        
+        snipers &= snipers - 1;
+    }
+    
+    return pinned;
+}
+
+template<Color Us>
+void Board::add_promotions(MoveList& move_list, Square from, Square to) {
+    move_list.push_back(Move(from, to, PROMOTION, relative_piece<Us>(WQ)));
+    move_list.push_back(Move(from, to, PROMOTION, relative_piece<Us>(WR)));
+    move_list.push_back(Move(from, to, PROMOTION, relative_piece<Us>(WB)));
+    move_list.push_back(Move(from, to, PROMOTION, relative_piece<Us>(WN)));
+}
+
+template<Color Us, GenType Type>
+void Board::generate_moves(MoveList& move_list) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    uint64_t friendly_pieces = Us == WHITE ? white_pieces : black_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
+    
+    Square king_square = static_cast<Square>(__builtin_ctzll(bitboards[relative_piece<Us>(WK)]));
+    uint64_t checkers = attackers_of<Them>(king_square, all_pieces);
+    
+    // The node's shared attack map already has the king lifted off the board, so it cannot hide behind itself
+    uint64_t danger = attack_map().king_danger;
+    uint64_t stage_targets = Type == CAPTURES ? enemy_pieces : Type == QUIETS ? ~all_pieces : ~friendly_pieces;
+    uint64_t king_targets = king_attacks[king_square] & stage_targets & ~danger;
+    while (king_targets) {
+        Square to = static_cast<Square>(__builtin_ctzll(king_targets));
+        MoveType type = (enemy_pieces & (1ULL << to)) ? CAPTURE : NORMAL;
+        move_list.push_back(Move(king_square, to, type));
+        king_targets &= king_targets - 1;
+    }
+    
+    // Double check: only the king may move
+    if (checkers & (checkers - 1)) {
+        return;
+    }
+    
+    uint64_t check_mask = ~0ULL;
+    if (checkers) {
+        Square checker = static_cast<Square>(__builtin_ctzll(checkers));
+        check_mask = checkers | between[king_square][checker];
+    } else if (Type != CAPTURES) {
+        constexpr int king_side = Us == WHITE ? 1 : 4;
+        constexpr int queen_side = Us == WHITE ? 2 : 8;
+        constexpr uint64_t king_side_path = Us == WHITE ? 0x60ULL : 0x6000000000000000ULL;
+        constexpr uint64_t queen_side_path = Us == WHITE ? 0x0EULL : 0x0E00000000000000ULL;
+        constexpr uint64_t queen_side_transit = Us == WHITE ? 0x0CULL : 0x0C00000000000000ULL;
+        
+        if ((castling_rights & king_side) && !(all_pieces & king_side_path) && !(danger & king_side_path)) {
+            move_list.push_back(Move(king_square, static_cast<Square>(king_square + 2), CASTLE_KING));
+        }
+        
+        if ((castling_rights & queen_side) && !(all_pieces & queen_side_path) && !(danger & queen_side_transit)) {
+            move_list.push_back(Move(king_square, static_cast<Square>(king_square - 2), CASTLE_QUEEN));
+        }
+    }
+    
+    uint64_t pinned = pinned_pieces<Us>(king_square);
+    uint64_t targets = stage_targets & check_mask;
+    
+    uint64_t knights = bitboards[relative_piece<Us>(WN)] & ~pinned;
+    while (knights) {
+        Square from = static_cast<Square>(__builtin_ctzll(knights));
+        uint64_t attacks = knight_attacks[from] & targets;
+        
+        while (attacks) {
+            Square to = static_cast<Square>(__builtin_ctzll(attacks));
+            MoveType type = (enemy_pieces & (1ULL << to)) ? CAPTURE : NORMAL;
+            move_list.push_back(Move(from, to, type));
+            attacks &= attacks - 1;
+        }
+        
+        knights &= knights - 1;
+    }
+    
+    uint64_t queens = bitboards[relative_piece<Us>(WQ)];
+    uint64_t rook_movers = bitboards[relative_piece<Us>(WR)] | queens;
+    uint64_t bishop_movers = bitboards[relative_piece<Us>(WB)] | queens;
+    uint64_t sliders = rook_movers | bishop_movers;
+    while (sliders) {
+        Square from = static_cast<Square>(__builtin_ctzll(sliders));
+        uint64_t from_bit = 1ULL << from;
+        uint64_t attacks = 0ULL;
+        
+        if (rook_movers & from_bit) {
+            attacks |= MagicBitboards::get_rook_attacks(from, all_pieces);
+        }
+        if (bishop_movers & from_bit) {
+            attacks |= MagicBitboards::get_bishop_attacks(from, all_pieces);
+        }
+        
+        attacks &= targets;
+        if (pinned & from_bit) {
+            attacks &= line[king_square][from];
+        }
+        
+        while (attacks) {
+            Square to = static_cast<Square>(__builtin_ctzll(attacks));
+            MoveType type = (enemy_pieces & (1ULL << to)) ? CAPTURE : NORMAL;
+            move_list.push_back(Move(from, to, type));
+            attacks &= attacks - 1;
+        }
+        
+        sliders &= sliders - 1;
+    }
+    
+    uint64_t pawns = bitboards[relative_piece<Us>(WP)];
+    uint64_t empty = ~all_pieces;
+    
+    uint64_t single_pushes = shift_forward<Us>(pawns) & empty;
+    uint64_t double_pushes = shift_forward<Us>(single_pushes & relative_rank_mask<Us>(2)) & empty;
+    uint64_t left_captures = shift_forward_left<Us>(pawns) & enemy_pieces;
+    uint64_t right_captures = shift_forward_right<Us>(pawns) & enemy_pieces;
+    
+    // Promotions count as captures for staging, whether or not they take a piece
+    if (Type == CAPTURES) {
+        single_pushes &= relative_rank_mask<Us>(7);
+        double_pushes = 0ULL;
+    } else if (Type == QUIETS) {
+        single_pushes &= ~relative_rank_mask<Us>(7);
+        left_captures = 0ULL;
+        right_captures = 0ULL;
+    }
+    
+    const PawnTargets pawn_targets[4] = {
+        {single_pushes & check_mask, forward_offset<Us>(), NORMAL},
+        {double_pushes & check_mask, 2 * forward_offset<Us>(), NORMAL},
+        {left_captures & check_mask, forward_left_offset<Us>(), CAPTURE},
+        {right_captures & check_mask, forward_right_offset<Us>(), CAPTURE}
+    };
+    
+    for (const PawnTargets& group : pawn_targets) {
+        uint64_t squares = group.squares;
+        
+        while (squares) {
+            Square to = static_cast<Square>(__builtin_ctzll(squares));
+            Square from = static_cast<Square>(to - group.offset);
+            squares &= squares - 1;
+            
+            if ((pinned & (1ULL << from)) && !(line[king_square][from] & (1ULL << to))) {
+                continue;
+            }
+            
+            if ((1ULL << to) & relative_rank_mask<Us>(7)) {
+                add_promotions<Us>(move_list, from, to);
+            } else {
+                move_list.push_back(Move(from, to, group.type));
+            }
+        }
+    }
+    
+    if (Type != QUIETS && en_passant_square != -1) {
+        Square to = static_cast<Square>(en_passant_square);
+        uint64_t to_bit = 1ULL << to;
+        Square captured = static_cast<Square>(to - forward_offset<Us>());
+        uint64_t captured_bit = 1ULL << captured;
+        uint64_t ep_pawns = 0ULL;
+        
+        if (check_mask & (to_bit | captured_bit)) {
+            ep_pawns = pawns & pawn_attacks[Them][to];
+        }
+        
+        uint64_t enemy_queens = bitboards[relative_piece<Them>(WQ)];
+        uint64_t enemy_rooks = bitboards[relative_piece<Them>(WR)] | enemy_queens;
+        uint64_t enemy_bishops = bitboards[relative_piece<Them>(WB)] | enemy_queens;
+        
+        while (ep_pawns) {
+            Square from = static_cast<Square>(__builtin_ctzll(ep_pawns));
+            
+            // Two pawns leave the rank at once, so replay the occupancy instead of trusting the pin mask
+            uint64_t occupancy = (all_pieces ^ (1ULL << from) ^ captured_bit) | to_bit;
+            bool exposes_king = (MagicBitboards::get_rook_attacks(king_square, occupancy) & enemy_rooks) ||
+                                (MagicBitboards::get_bishop_attacks(king_square, occupancy) & enemy_bishops);
+            
+            if (!exposes_king) {
+                move_list.push_back(Move(from, to, EN_PASSANT));
+            }
+            
+            ep_pawns &= ep_pawns - 1;
+        }
+    }
+}
+
+void Board::generate_moves(MoveList& move_list) {
+    side_to_move ? generate_moves<WHITE, ALL_MOVES>(move_list) : generate_moves<BLACK, ALL_MOVES>(move_list);
+}
+
+void Board::generate_captures(MoveList& move_list) {
+    side_to_move ? generate_moves<WHITE, CAPTURES>(move_list) : generate_moves<BLACK, CAPTURES>(move_list);
+}
+
+void Board::generate_quiets(MoveList& move_list) {
+    side_to_move ? generate_moves<WHITE, QUIETS>(move_list) : generate_moves<BLACK, QUIETS>(move_list);
+}
+
+
+template<Color Us>
+bool Board::is_pseudo_legal(const Move& move) const {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    Square from = move.from();
+    Square to = move.to();
+    Piece piece = piece_on[from];
+    uint64_t to_bit = 1ULL << to;
+    uint64_t friendly_pieces = Us == WHITE ? white_pieces : black_pieces;
+    uint64_t enemy_pieces = Us == WHITE ? black_pieces : white_pieces;
+    
+    // Only flags 0-4 and 8-11 are ever encoded; anything else is a corrupt hash move
+    int flags = move.data >> 12;
+    if ((flags > CASTLE_QUEEN && flags < 8) || flags > 11) {
+        return false;
+    }
+    
+    if (piece == NO_PIECE || (piece < BP) != (Us == WHITE) || (friendly_pieces & to_bit)) {
+        return false;
+    }
+    
+    MoveType type = move.type();
+    bool is_capture = (enemy_pieces & to_bit) != 0ULL;
+    
+    if (piece == relative_piece<Us>(WP)) {
+        if (type == EN_PASSANT) {
+            return to == en_passant_square && (pawn_attacks[Us][from] & to_bit);
+        }
+        if (type != PROMOTION && type != (is_capture ? CAPTURE : NORMAL)) {
+            return false;
+        }
+        if ((type == PROMOTION) != ((to_bit & relative_rank_mask<Us>(7)) != 0ULL)) {
+            return false;
+        }
+        if (is_capture) {
+            return (pawn_attacks[Us][from] & to_bit) != 0ULL;
+        }
+        
+        uint64_t single_push = shift_forward<Us>(1ULL << from) & ~all_pieces;
+        uint64_t double_push = shift_forward<Us>(single_push & relative_rank_mask<Us>(2)) & ~all_pieces;
+        return ((single_push | double_push) & to_bit) != 0ULL;
+    }
+    
+    if (type == CASTLE_KING || type == CASTLE_QUEEN) {
+        constexpr Square king_start = Us == WHITE ? E1 : E8;
+        bool king_side = type == CASTLE_KING;
+        int right = (king_side ? 1 : 2) << (Us == WHITE ? 0 : 2);
+        uint64_t path = king_side ? (Us == WHITE ? 0x60ULL : 0x6000000000000000ULL)
+                                  : (Us == WHITE ? 0x0EULL : 0x0E00000000000000ULL);
+        Square transit = static_cast<Square>(king_side ? king_start + 1 : king_start - 1);
+        
+        return piece == relative_piece<Us>(WK) && from == king_start &&
+               to == (king_side ? king_start + 2 : king_start - 2) &&
+               (castling_rights & right) && !(all_pieces & path) &&
+               !attackers_of<Them>(king_start, all_pieces) && !attackers_of<Them>(transit, all_pieces);
+    }
+    
+    if (type != (is_capture ? CAPTURE : NORMAL)) {
+        return false;
+    }
+    
+    uint64_t attacks = 0ULL;
+    switch (piece % 6) {
+        case WN: attacks = knight_attacks[from]; break;
+        case WB: attacks = MagicBitboards::get_bishop_attacks(from, all_pieces); break;
+        case WR: attacks = MagicBitboards::get_rook_attacks(from, all_pieces); break;
+        case WQ: attacks = MagicBitboards::get_rook_attacks(from, all_pieces) |
+                           MagicBitboards::get_bishop_attacks(from, all_pieces); break;
+        case WK: attacks = king_attacks[from]; break;
+    }
+    
+    return (attacks & to_bit) != 0ULL;
+}
+
+bool Board::is_legal(const Move& move) {
+    bool pseudo_legal = side_to_move ? is_pseudo_legal<WHITE>(move) : is_pseudo_legal<BLACK>(move);
+    if (!pseudo_legal) {
+        return false;
+    }
+    
+    // Rare path (hash and killer moves), so let make_move settle pins and discovered checks
+    bool white = side_to_move;
+    UndoInfo undo;
+    make_move(move, undo);
+    bool legal = !is_square_attacked(static_cast<Square>(__builtin_ctzll(bitboards[white ? WK : BK])), !white);
+    unmake_move();
+    
+    return legal;
+}
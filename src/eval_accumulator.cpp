@@ -0,0 +1,113 @@
+#include "eval_accumulator.h"
+#include "geometric_evaluator.h"
+#include "magic_bitboards.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// Squares whose occupancy decides the slider's influence: its attack set ends on each blocker
+uint64_t slider_reach(Piece piece, Square square, uint64_t occupancy) {
+    switch (piece % 6) {
+        case WB: return MagicBitboards::get_bishop_attacks(square, occupancy);
+        case WR: return MagicBitboards::get_rook_attacks(square, occupancy);
+        case WQ: return MagicBitboards::get_bishop_attacks(square, occupancy) |
+                        MagicBitboards::get_rook_attacks(square, occupancy);
+        default: return 0ULL;
+    }
+}
+
+bool is_slider(Piece piece) {
+    int type = piece % 6;
+    return type == WB || type == WR || type == WQ;
+}
+
+#ifdef DEBUG_MODE
+bool nearly_equal(float a, float b) {
+    return std::fabs(a - b) <= 1e-3f * std::max(1.0f, std::fabs(b));
+}
+#endif
+
+}
+
+void EvalAccumulator::reset(const Board& board) {
+    top = 0;
+    Entry& entry = stack[0];
+    entry.occupancy = board.all_pieces;
+    entry.pawns[0] = entry.pawns[1] = entry.pieces = Multivector2D();
+    
+    for (int piece = WP; piece <= BK; ++piece) {
+        entry.bitboards[piece] = board.bitboards[piece];
+        
+        for (uint64_t pieces = board.bitboards[piece]; pieces; pieces &= pieces - 1) {
+            Square square = static_cast<Square>(__builtin_ctzll(pieces));
+            add_piece(entry, static_cast<Piece>(piece), square, board.all_pieces, 1.0f);
+        }
+    }
+}
+
+void EvalAccumulator::push(const Board& board) {
+    const Entry& parent = stack[top];
+    Entry& entry = stack[++top];
+    entry = parent;
+    entry.occupancy = board.all_pieces;
+    
+    // Removals are priced with the parent's occupancy and additions with the child's,
+    // matching what a full evaluation of each position counted
+    uint64_t changed = parent.occupancy ^ board.all_pieces;
+    for (int index = WP; index <= BK; ++index) {
+        Piece piece = static_cast<Piece>(index);
+        uint64_t before = parent.bitboards[piece];
+        uint64_t after = board.bitboards[piece];
+        entry.bitboards[piece] = after;
+        
+        for (uint64_t removed = before & ~after; removed; removed &= removed - 1) {
+            Square square = static_cast<Square>(__builtin_ctzll(removed));
+            add_piece(entry, piece, square, parent.occupancy, -1.0f);
+        }
+        for (uint64_t added = after & ~before; added; added &= added - 1) {
+            Square square = static_cast<Square>(__builtin_ctzll(added));
+            add_piece(entry, piece, square, board.all_pieces, 1.0f);
+        }
+        
+        // A slider that stayed put only changes when a square it reached changed occupancy
+        if (!changed || !is_slider(piece)) {
+            continue;
+        }
+        for (uint64_t stayed = before & after; stayed; stayed &= stayed - 1) {
+            Square square = static_cast<Square>(__builtin_ctzll(stayed));
+            if (slider_reach(piece, square, parent.occupancy) & changed) {
+                add_piece(entry, piece, square, parent.occupancy, -1.0f);
+                add_piece(entry, piece, square, board.all_pieces, 1.0f);
+            }
+        }
+    }
+    
+#ifdef DEBUG_MODE
+    Multivector2D incremental = value(board);
+    Multivector2D full = GeometricEvaluator::evaluate_position(board);
+    assert(incremental.get_scalar() == full.get_scalar());
+    assert(nearly_equal(incremental.get_vector().x, full.get_vector().x));
+    assert(nearly_equal(incremental.get_vector().y, full.get_vector().y));
+    assert(nearly_equal(incremental.get_bivector().magnitude, full.get_bivector().magnitude));
+#endif
+}
+
+Multivector2D EvalAccumulator::value(const Board& board) const {
+    const Entry& entry = stack[top];
+    return entry.pieces + entry.pawns[board.side_to_move ? 1 : 0];
+}
+
+// Adds (sign 1) or removes (sign -1) one piece's term as evaluated under occupancy
+void EvalAccumulator::add_piece(Entry& entry, Piece piece, Square square, uint64_t occupancy, float sign) {
+    if (piece % 6 == WP) {
+        for (int white_to_move = 0; white_to_move < 2; ++white_to_move) {
+            Multivector2D term = GeometricEvaluator::piece_contribution(piece, square, occupancy, white_to_move);
+            entry.pawns[white_to_move].fma(term, sign);
+        }
+    } else {
+        Multivector2D term = GeometricEvaluator::piece_contribution(piece, square, occupancy, false);
+        entry.pieces.fma(term, sign);
+    }
+}
@@ -0,0 +1,74 @@
+#include "eval_cache.h"
+#include <cstring>
+
+static_assert(sizeof(Multivector2D) == 2 * sizeof(uint64_t), "a cached multivector is packed into two words");
+
+namespace {
+
+// Plain key ^ low ^ high would accept data from another write whenever its two words xor
+// to the same value; running the high word through a bijective mix first breaks that
+uint64_t check_word(uint64_t key, const uint64_t (&words)[2]) {
+    uint64_t high = words[1];
+    high ^= high >> 33;
+    high *= 0xFF51AFD7ED558CCDULL;
+    high ^= high >> 33;
+    high *= 0xC4CEB9FE1A85EC53ULL;
+    high ^= high >> 33;
+    return key ^ words[0] ^ high;
+}
+
+}
+
+EvalCache::EvalCache(size_t megabytes) : mask(0), hit_count(0), miss_count(0) {
+    resize(megabytes);
+}
+
+void EvalCache::resize(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    
+    mask = count - 1;
+    entries.reset(new Entry[count]);
+    clear();
+}
+
+void EvalCache::clear() {
+    // An empty entry reads as key 0, which a Zobrist key practically never is
+    for (size_t i = 0; i <= mask; ++i) {
+        entries[i].check.store(0, std::memory_order_relaxed);
+        entries[i].low.store(0, std::memory_order_relaxed);
+        entries[i].high.store(0, std::memory_order_relaxed);
+    }
+    hit_count.store(0, std::memory_order_relaxed);
+    miss_count.store(0, std::memory_order_relaxed);
+}
+
+bool EvalCache::probe(uint64_t key, Multivector2D& result) const {
+    const Entry& entry = entries[key & mask];
+    uint64_t words[2] = {
+        entry.low.load(std::memory_order_relaxed),
+        entry.high.load(std::memory_order_relaxed)
+    };
+    
+    if (entry.check.load(std::memory_order_relaxed) != check_word(key, words)) {
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    std::memcpy(&result, words, sizeof(words));
+    hit_count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Always replaces: evaluations are equally cheap to redo, so recency is the only priority
+void EvalCache::store(uint64_t key, const Multivector2D& result) {
+    uint64_t words[2];
+    std::memcpy(words, &result, sizeof(words));
+    
+    Entry& entry = entries[key & mask];
+    entry.low.store(words[0], std::memory_order_relaxed);
+    entry.high.store(words[1], std::memory_order_relaxed);
+    entry.check.store(check_word(key, words), std::memory_order_relaxed);
+}
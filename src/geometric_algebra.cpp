@@ -1,45 +1,5 @@
 #include "geometric_algebra.h"
 
-// Implementação dos construtores da classe Multivector2D
-Multivector2D::Multivector2D() 
-    : scalar_part(0.0f), vector_part(0.0f, 0.0f), bivector_part(0.0f) {}
-
-Multivector2D::Multivector2D(float scalar) 
-    : scalar_part(scalar), vector_part(0.0f, 0.0f), bivector_part(0.0f) {}
-
-Multivector2D::Multivector2D(const Vector2D& vector) 
-    : scalar_part(0.0f), vector_part(vector), bivector_part(0.0f) {}
-
-Multivector2D::Multivector2D(const Bivector2D& bivector) 
-    : scalar_part(0.0f), vector_part(0.0f, 0.0f), bivector_part(bivector) {}
-
-Multivector2D::Multivector2D(float scalar, const Vector2D& vector, const Bivector2D& bivector) 
-    : scalar_part(scalar), vector_part(vector), bivector_part(bivector) {}
-
-// Implementação do operador de adição
-Multivector2D Multivector2D::operator+(const Multivector2D& other) const {
-    float new_scalar = scalar_part + other.scalar_part;
-    Vector2D new_vector(vector_part.x + other.vector_part.x, 
-                       vector_part.y + other.vector_part.y);
-    Bivector2D new_bivector(bivector_part.magnitude + other.bivector_part.magnitude);
-    
-    return Multivector2D(new_scalar, new_vector, new_bivector);
-}
-
-// Implementação do operador de multiplicação por escalar
-Multivector2D Multivector2D::operator*(float scalar) const {
-    float new_scalar = scalar_part * scalar;
-    Vector2D new_vector(vector_part.x * scalar, vector_part.y * scalar);
-    Bivector2D new_bivector(bivector_part.magnitude * scalar);
-    
-    return Multivector2D(new_scalar, new_vector, new_bivector);
-}
-
-// Implementação do operador de multiplicação por escalar (comutativo)
-Multivector2D operator*(float scalar, const Multivector2D& mv) {
-    return mv * scalar;
-}
-
 // Implementação das funções auxiliares para vetores
 float dot_product(const Vector2D& a, const Vector2D& b) {
     return a.x * b.x + a.y * b.y;
@@ -50,32 +10,55 @@ float wedge_product(const Vector2D& a, const Vector2D& b) {
 }
 
 // Implementação do produto geométrico
+// (a0 + a1*e1 + a2*e2 + a12*e12) * (b0 + b1*e1 + b2*e2 + b12*e12)
+//
+// Cada componente de a multiplica uma permutação de b com sinais (e1*e1 = 1, e2*e2 = 1,
+// e12*e12 = -1, e12*e1 = e2, e12*e2 = -e1), e as quatro parcelas são somadas:
+//   a0  * [ b0,   b1,   b2,   b12]
+//   a1  * [ b1,   b0,   b12,  b2 ]
+//   a2  * [ b2,  -b12,  b0,  -b1 ]
+//   a12 * [-b12,  b2,  -b1,   b0 ]
 Multivector2D geometric_product(const Multivector2D& a, const Multivector2D& b) {
-    // Extrair componentes dos multivetores
-    float a0 = a.get_scalar();
-    Vector2D a_vec = a.get_vector();
-    float a12 = a.get_bivector().magnitude;
-    
-    float b0 = b.get_scalar();
-    Vector2D b_vec = b.get_vector();
-    float b12 = b.get_bivector().magnitude;
+    Multivector2D result;
+
+#if defined(FIXED_POINT_EVAL)
+    // Produtos em 64 bits, reescalados uma única vez com arredondamento para o mais próximo
+    const int32_t* x = a.components;
+    const int32_t* y = b.components;
+    const int64_t b_swapped[4] = {y[1], y[0], y[3], y[2]};
+    const int64_t b_rotated[4] = {y[2], -int64_t(y[3]), y[0], -int64_t(y[1])};
+    const int64_t b_reversed[4] = {-int64_t(y[3]), y[2], -int64_t(y[1]), y[0]};
     
-    // Calcular o produto geométrico usando as regras da álgebra geométrica em 2D
-    // (a0 + a1*e1 + a2*e2 + a12*e12) * (b0 + b1*e1 + b2*e2 + b12*e12)
+    for (int i = 0; i < 4; i++) {
+        int64_t sum = x[0] * int64_t(y[i]) + x[1] * b_swapped[i] + x[2] * b_rotated[i] + x[3] * b_reversed[i];
+        int64_t half = sum < 0 ? -FIXED_POINT_SCALE / 2 : FIXED_POINT_SCALE / 2;
+        result.components[i] = static_cast<int32_t>((sum + half) / FIXED_POINT_SCALE);
+    }
+#elif defined(__SSE2__)
+    __m128 va = _mm_load_ps(a.components);
+    __m128 vb = _mm_load_ps(b.components);
     
-    // Parte escalar: a0*b0 + a1*b1 + a2*b2 - a12*b12
-    // (e1*e1 = 1, e2*e2 = 1, e12*e12 = -1)
-    float result_scalar = a0 * b0 + dot_product(a_vec, b_vec) - a12 * b12;
+    __m128 b_swapped = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 b_rotated = _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(1, 0, 3, 2)), _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+    __m128 b_reversed = _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(0, 1, 2, 3)), _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f));
     
-    // Parte vetorial: a0*b_vec + b0*a_vec + a12*(b2*e1 - b1*e2) + b12*(a2*e1 - a1*e2)
-    // (e12*e1 = e2, e12*e2 = -e1)
-    Vector2D result_vector;
-    result_vector.x = a0 * b_vec.x + b0 * a_vec.x + a12 * b_vec.y - b12 * a_vec.y;
-    result_vector.y = a0 * b_vec.y + b0 * a_vec.y - a12 * b_vec.x + b12 * a_vec.x;
+    __m128 sum = _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(0, 0, 0, 0)), vb);
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(1, 1, 1, 1)), b_swapped));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 2, 2)), b_rotated));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 3, 3)), b_reversed));
+    _mm_store_ps(result.components, sum);
+#else
+    // Mesma ordem de operações do caminho SSE, para resultados idênticos
+    const float* x = a.components;
+    const float* y = b.components;
+    const float b_swapped[4] = {y[1], y[0], y[3], y[2]};
+    const float b_rotated[4] = {y[2], -y[3], y[0], -y[1]};
+    const float b_reversed[4] = {-y[3], y[2], -y[1], y[0]};
     
-    // Parte bivetorial: a0*b12 + b0*a12 + a1*b2 - a2*b1
-    // (e1*e2 = e12, e2*e1 = -e12)
-    float result_bivector = a0 * b12 + b0 * a12 + wedge_product(a_vec, b_vec);
+    for (int i = 0; i < 4; i++) {
+        result.components[i] = x[0] * y[i] + x[1] * b_swapped[i] + x[2] * b_rotated[i] + x[3] * b_reversed[i];
+    }
+#endif
     
-    return Multivector2D(result_scalar, result_vector, Bivector2D(result_bivector));
-} 
\ No newline at end of file
+    return result;
+}
@@ -1,157 +1,182 @@
 #include "geometric_evaluator.h"
+#include "kogge_stone.h"
 
 Multivector2D GeometricEvaluator::calculate_piece_influence(PieceType piece, Square square, const Board& board) {
+    return calculate_piece_influence(piece, square, board.all_pieces, board.side_to_move);
+}
+
+namespace {
+
+constexpr float PIECE_WEIGHTS[13] = {
+    1.0f, 3.0f, 3.0f, 5.0f, 9.0f, 1000.0f,
+    -1.0f, -3.0f, -3.0f, -5.0f, -9.0f, -1000.0f,
+    0.0f
+};
+
+constexpr PieceType type_of(Piece piece) {
+    return static_cast<PieceType>(piece % 6);
+}
+
+constexpr Multivector2D to_multivector(const InfluenceTerm& term) {
+    return Multivector2D(0.0f, Vector2D(term.x, term.y), Bivector2D(term.bivector));
+}
+
+// INFLUENCE_TABLES converted to the multivector backend at compile time, so a fixed-point
+// build does not pay a float conversion per lookup
+struct InfluenceMultivectors {
+    Multivector2D pawn[2][64];
+    Multivector2D knight[64];
+    Multivector2D king[64];
+};
+
+constexpr InfluenceMultivectors make_influence_multivectors() {
+    InfluenceMultivectors multivectors{};
+    for (int square = 0; square < 64; square++) {
+        multivectors.pawn[0][square] = to_multivector(INFLUENCE_TABLES.pawn[0][square]);
+        multivectors.pawn[1][square] = to_multivector(INFLUENCE_TABLES.pawn[1][square]);
+        multivectors.knight[square] = to_multivector(INFLUENCE_TABLES.knight[square]);
+        multivectors.king[square] = to_multivector(INFLUENCE_TABLES.king[square]);
+    }
+    return multivectors;
+}
+
+constexpr InfluenceMultivectors INFLUENCE_MULTIVECTORS = make_influence_multivectors();
+
+}
+
+template<>
+Multivector2D GeometricEvaluator::calculate_influence<PieceType::PAWN>(Square square, uint64_t, bool white_to_move) {
+    return INFLUENCE_MULTIVECTORS.pawn[white_to_move ? 0 : 1][square];
+}
+
+template<>
+Multivector2D GeometricEvaluator::calculate_influence<PieceType::KNIGHT>(Square square, uint64_t, bool) {
+    return INFLUENCE_MULTIVECTORS.knight[square];
+}
+
+template<>
+Multivector2D GeometricEvaluator::calculate_influence<PieceType::BISHOP>(Square square, uint64_t occupancy, bool) {
+    return slider_influence(popcount(MagicBitboards::get_bishop_attacks(square, occupancy)));
+}
+
+template<>
+Multivector2D GeometricEvaluator::calculate_influence<PieceType::ROOK>(Square square, uint64_t occupancy, bool) {
+    return slider_influence(popcount(MagicBitboards::get_rook_attacks(square, occupancy)));
+}
+
+template<>
+Multivector2D GeometricEvaluator::calculate_influence<PieceType::QUEEN>(Square square, uint64_t occupancy, bool) {
+    return slider_influence(popcount(MagicBitboards::get_bishop_attacks(square, occupancy))) +
+           slider_influence(popcount(MagicBitboards::get_rook_attacks(square, occupancy)));
+}
+
+template<>
+Multivector2D GeometricEvaluator::calculate_influence<PieceType::KING>(Square square, uint64_t, bool) {
+    return INFLUENCE_MULTIVECTORS.king[square];
+}
+
+// A slider's two planes of movement each carry half of its mobility, attacks / 14
+Multivector2D GeometricEvaluator::slider_influence(int attack_count) {
+#if defined(FIXED_POINT_EVAL)
+    // FIXED_POINT_SCALE is a multiple of 28, so each half is a whole number of units
+    Multivector2D::Component half = attack_count * (FIXED_POINT_SCALE / 28);
+    return Multivector2D::from_components(0, 0, 0, half + half);
+#else
+    float magnitude = static_cast<float>(attack_count) / 14.0f;
+    return Multivector2D(Bivector2D(magnitude * 0.5f)) + Multivector2D(Bivector2D(magnitude * 0.5f));
+#endif
+}
+
+Multivector2D GeometricEvaluator::calculate_piece_influence(PieceType piece, Square square, uint64_t occupancy, bool white_to_move) {
     switch (piece) {
         case PieceType::PAWN:
-            return calculate_pawn_influence(square, board);
+            return calculate_influence<PieceType::PAWN>(square, occupancy, white_to_move);
         case PieceType::KNIGHT:
-            return calculate_knight_influence(square, board);
+            return calculate_influence<PieceType::KNIGHT>(square, occupancy, white_to_move);
         case PieceType::BISHOP:
-            return calculate_bishop_influence(square, board);
+            return calculate_influence<PieceType::BISHOP>(square, occupancy, white_to_move);
         case PieceType::ROOK:
-            return calculate_rook_influence(square, board);
+            return calculate_influence<PieceType::ROOK>(square, occupancy, white_to_move);
         case PieceType::QUEEN:
-            return calculate_queen_influence(square, board);
+            return calculate_influence<PieceType::QUEEN>(square, occupancy, white_to_move);
         case PieceType::KING:
-            return calculate_king_influence(square, board);
+            return calculate_influence<PieceType::KING>(square, occupancy, white_to_move);
         default:
             return Multivector2D();
     }
 }
 
-Multivector2D GeometricEvaluator::evaluate_position(const Board& board) {
-    Multivector2D M_total;
-    
-    for (int piece_type = WP; piece_type <= BK; piece_type++) {
-        uint64_t piece_bitboard = board.bitboards[piece_type];
-        
-        while (piece_bitboard) {
-            int square_index = __builtin_ctzll(piece_bitboard);
-            Square square = static_cast<Square>(square_index);
-            
-            Piece piece = static_cast<Piece>(piece_type);
-            PieceType type = piece_to_type(piece);
-            float weight = get_piece_weight(piece);
-            
-            Multivector2D influence = calculate_piece_influence(type, square, board);
-            Multivector2D weighted_influence = influence * weight;
-            
-            M_total = M_total + weighted_influence;
-            
-            piece_bitboard &= piece_bitboard - 1;
-        }
-    }
-    
-    return M_total;
+Multivector2D GeometricEvaluator::piece_contribution(Piece piece, Square square, uint64_t occupancy, bool white_to_move) {
+    // The piece itself is the grade-0 part, so the weighted scalar is the material balance
+    Multivector2D influence = Multivector2D(1.0f) + calculate_piece_influence(piece_to_type(piece), square, occupancy, white_to_move);
+    return Multivector2D().fma(influence, get_piece_weight(piece));
 }
 
-float GeometricEvaluator::get_final_score(const Multivector2D& m_total) {
-    return m_total.get_scalar();
-}
-
-Multivector2D GeometricEvaluator::calculate_pawn_influence(Square square, const Board& board) {
-    Vector2D coords = square_to_coords(square);
-    bool is_white = board.side_to_move;
-    
-    Vector2D forward_move, left_capture, right_capture;
-    
-    if (is_white) {
-        forward_move = Vector2D(0.0f, 1.0f);
-        left_capture = Vector2D(-1.0f, 1.0f);
-        right_capture = Vector2D(1.0f, 1.0f);
-    } else {
-        forward_move = Vector2D(0.0f, -1.0f);
-        left_capture = Vector2D(-1.0f, -1.0f);
-        right_capture = Vector2D(1.0f, -1.0f);
+template<Piece P>
+void GeometricEvaluator::add_pieces(Multivector2D& m_total, const Board& board) {
+    for (uint64_t pieces = board.bitboards[P]; pieces; pieces &= pieces - 1) {
+        Square square = static_cast<Square>(__builtin_ctzll(pieces));
+        
+        // The piece itself is the grade-0 part, so the weighted scalar is the material balance
+        Multivector2D influence = Multivector2D(1.0f) +
+            calculate_influence<type_of(P)>(square, board.all_pieces, board.side_to_move);
+        m_total.fma(influence, PIECE_WEIGHTS[P]);
     }
-    
-    Multivector2D forward_mv(forward_move);
-    Multivector2D left_mv(left_capture);
-    Multivector2D right_mv(right_capture);
-    
-    return forward_mv + left_mv + right_mv;
 }
 
-Multivector2D GeometricEvaluator::calculate_knight_influence(Square square, const Board& board) {
-    const Vector2D knight_moves[8] = {
-        Vector2D(1.0f, 2.0f), Vector2D(2.0f, 1.0f),
-        Vector2D(2.0f, -1.0f), Vector2D(1.0f, -2.0f),
-        Vector2D(-1.0f, -2.0f), Vector2D(-2.0f, -1.0f),
-        Vector2D(-2.0f, 1.0f), Vector2D(-1.0f, 2.0f)
-    };
-    
-    Multivector2D total_influence;
-    for (int i = 0; i < 8; i++) {
-        Multivector2D move_mv(knight_moves[i]);
-        total_influence = total_influence + move_mv;
+// All sliders of one type in one term: their count is the material and one set-wise fill
+// yields the sum of the attack counts the per-square kernels would have popcounted
+template<Piece P>
+void GeometricEvaluator::add_sliders(Multivector2D& m_total, const Board& board) {
+    uint64_t pieces = board.bitboards[P];
+    if (!pieces) {
+        return;
     }
     
-    return total_influence;
+    uint64_t orthogonal = type_of(P) == PieceType::BISHOP ? 0ULL : pieces;
+    uint64_t diagonal = type_of(P) == PieceType::ROOK ? 0ULL : pieces;
+    Multivector2D sliders = Multivector2D(static_cast<float>(popcount(pieces))) +
+        slider_influence(KoggeStone::slider_mobility(orthogonal, diagonal, board.all_pieces));
+    m_total.fma(sliders, PIECE_WEIGHTS[P]);
 }
 
-Multivector2D GeometricEvaluator::calculate_bishop_influence(Square square, const Board& board) {
-    uint64_t attack_bitboard = MagicBitboards::get_bishop_attacks(square, board.all_pieces);
-    int attack_count = popcount(attack_bitboard);
-    
-    float magnitude = static_cast<float>(attack_count) / 14.0f;
-    
-    Bivector2D diagonal1(magnitude * 0.5f);
-    Bivector2D diagonal2(magnitude * 0.5f);
-    
-    Multivector2D biv1(diagonal1);
-    Multivector2D biv2(diagonal2);
-    
-    return biv1 + biv2;
-}
-
-Multivector2D GeometricEvaluator::calculate_rook_influence(Square square, const Board& board) {
-    uint64_t attack_bitboard = MagicBitboards::get_rook_attacks(square, board.all_pieces);
-    int attack_count = popcount(attack_bitboard);
-    
-    float magnitude = static_cast<float>(attack_count) / 14.0f;
-    
-    Bivector2D horizontal(magnitude * 0.5f);
-    Bivector2D vertical(magnitude * 0.5f);
+Multivector2D GeometricEvaluator::evaluate_position(const Board& board) {
+    Multivector2D M_total;
     
-    Multivector2D biv1(horizontal);
-    Multivector2D biv2(vertical);
+    add_pieces<WP>(M_total, board);
+    add_pieces<WN>(M_total, board);
+    add_sliders<WB>(M_total, board);
+    add_sliders<WR>(M_total, board);
+    add_sliders<WQ>(M_total, board);
+    add_pieces<WK>(M_total, board);
+    add_pieces<BP>(M_total, board);
+    add_pieces<BN>(M_total, board);
+    add_sliders<BB>(M_total, board);
+    add_sliders<BR>(M_total, board);
+    add_sliders<BQ>(M_total, board);
+    add_pieces<BK>(M_total, board);
     
-    return biv1 + biv2;
+    return M_total;
 }
 
-Multivector2D GeometricEvaluator::calculate_queen_influence(Square square, const Board& board) {
-    Multivector2D bishop_part = calculate_bishop_influence(square, board);
-    Multivector2D rook_part = calculate_rook_influence(square, board);
+Multivector2D GeometricEvaluator::evaluate_position(const Board& board, EvalCache& cache) {
+    Multivector2D M_total;
+    if (!cache.probe(board.hash_key, M_total)) {
+        M_total = evaluate_position(board);
+        cache.store(board.hash_key, M_total);
+    }
     
-    return bishop_part + rook_part;
+    return M_total;
 }
 
-Multivector2D GeometricEvaluator::calculate_king_influence(Square square, const Board& board) {
-    const Vector2D king_moves[8] = {
-        Vector2D(-1.0f, -1.0f), Vector2D(-1.0f, 0.0f), Vector2D(-1.0f, 1.0f),
-        Vector2D(0.0f, -1.0f), Vector2D(0.0f, 1.0f),
-        Vector2D(1.0f, -1.0f), Vector2D(1.0f, 0.0f), Vector2D(1.0f, 1.0f)
-    };
-    
-    Multivector2D total_influence;
-    for (int i = 0; i < 8; i++) {
-        Multivector2D move_mv(king_moves[i]);
-        total_influence = total_influence + move_mv;
-    }
-    
-    return total_influence;
+float GeometricEvaluator::get_final_score(const Multivector2D& m_total) {
+    return m_total.get_scalar();
 }
 
 int GeometricEvaluator::popcount(uint64_t bitboard) {
     return __builtin_popcountll(bitboard);
 }
 
-Vector2D GeometricEvaluator::square_to_coords(Square square) {
-    int file = square % 8;
-    int rank = square / 8;
-    return Vector2D(static_cast<float>(file), static_cast<float>(rank));
-}
-
 PieceType GeometricEvaluator::piece_to_type(Piece piece) {
     switch (piece) {
         case WP: case BP: return PieceType::PAWN;
@@ -165,19 +190,5 @@ PieceType GeometricEvaluator::piece_to_type(Piece piece) {
 }
 
 float GeometricEvaluator::get_piece_weight(Piece piece) {
-    switch (piece) {
-        case WP: return 1.0f;
-        case WN: return 3.0f;
-        case WB: return 3.0f;
-        case WR: return 5.0f;
-        case WQ: return 9.0f;
-        case WK: return 1000.0f;
-        case BP: return -1.0f;
-        case BN: return -3.0f;
-        case BB: return -3.0f;
-        case BR: return -5.0f;
-        case BQ: return -9.0f;
-        case BK: return -1000.0f;
-        default: return 0.0f;
-    }
-} 
\ No newline at end of file
+    return PIECE_WEIGHTS[piece];
+}
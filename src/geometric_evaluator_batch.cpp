@@ -0,0 +1,256 @@
+#include "geometric_evaluator.h"
+#include "position_batch.h"
+#include "kogge_stone.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t LANES = PositionBatch::LANES;
+// Pawn, knight and king influences are one integral entry for every square, so a lane's
+// vector part is exactly its piece counts times those entries, in any summation order
+static_assert(is_uniform_integral(INFLUENCE_TABLES.pawn[0]) && is_uniform_integral(INFLUENCE_TABLES.pawn[1]) &&
+              is_uniform_integral(INFLUENCE_TABLES.knight) && is_uniform_integral(INFLUENCE_TABLES.king),
+              "evaluate_batch needs square-independent, integral pawn, knight and king influences");
+// The bivector part is left to the slider rows
+static_assert(INFLUENCE_TABLES.pawn[0][0].bivector == 0.0f && INFLUENCE_TABLES.pawn[1][0].bivector == 0.0f &&
+              INFLUENCE_TABLES.knight[0].bivector == 0.0f && INFLUENCE_TABLES.king[0].bivector == 0.0f,
+              "evaluate_batch adds no bivector for pawns, knights or kings");
+
+constexpr int SLIDER_TYPES = 6;
+constexpr Piece SLIDERS[SLIDER_TYPES] = {WB, WR, WQ, BB, BR, BQ};
+
+// Whole-number terms a piece adds per unit of its count: its weight as material and its weighted
+// table entry as the vector part, the latter once for each side to move ([0] white)
+struct CountWeights {
+    int32_t material[12];
+    int32_t vector_x[2][12];
+    int32_t vector_y[2][12];
+};
+
+// Per-lane inputs and sums of one lane group
+struct LaneGroup {
+    // Material and vector part of each lane, already in the backend's component format
+    alignas(32) Multivector2D::Component material[LANES];
+    alignas(32) Multivector2D::Component vector_x[LANES];
+    alignas(32) Multivector2D::Component vector_y[LANES];
+    // Summed attack counts of each slider type, one row per type in evaluate_position's order
+    alignas(32) int32_t mobility[SLIDER_TYPES][LANES];
+    Multivector2D::Component weights[SLIDER_TYPES];
+    alignas(32) Multivector2D::Component bivectors[LANES];
+};
+
+// The per-square entry of an occupancy-independent piece; sliders have none
+constexpr InfluenceTerm fixed_influence(int piece, bool white_to_move) {
+    switch (piece % 6) {
+        case WP: return INFLUENCE_TABLES.pawn[white_to_move ? 0 : 1][0];
+        case WN: return INFLUENCE_TABLES.knight[0];
+        case WK: return INFLUENCE_TABLES.king[0];
+        default: return InfluenceTerm{};
+    }
+}
+
+Multivector2D lane_result(const LaneGroup& group, size_t lane) {
+    return Multivector2D::from_components(group.material[lane], group.vector_x[lane], group.vector_y[lane], group.bivectors[lane]);
+}
+
+#if defined(__AVX2__)
+// Popcounts of LANES neighbouring bitboards as 32-bit lanes: byte counts from a nibble table,
+// summed per bitboard by sad, then the two 4 x 64-bit halves packed into one register
+__m256i popcount_lanes(const uint64_t* bitboards) {
+    const __m256i nibble_counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                   0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    __m256i counts[2];
+    for (int half = 0; half < 2; ++half) {
+        __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitboards + 4 * half));
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(bits, low_nibbles)),
+                                        _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi64(bits, 4), low_nibbles)));
+        counts[half] = _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+    }
+    
+    // Interleave as a0 b0 a1 b1 ..., then gather the a's in front of the b's
+    __m256i packed = _mm256_blend_epi32(counts[0], _mm256_slli_epi64(counts[1], 32), 0xAA);
+    return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+}
+
+void store_whole_components(Multivector2D::Component* destination, __m256i values) {
+#if defined(FIXED_POINT_EVAL)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(destination), _mm256_mullo_epi32(values, _mm256_set1_epi32(FIXED_POINT_SCALE)));
+#else
+    _mm256_store_ps(destination, _mm256_cvtepi32_ps(values));
+#endif
+}
+
+// Material and vector parts of all lanes at once: per piece, one vector popcount and a
+// multiply-add per term; the side to move picks between the two vector sums per lane
+void add_counts(LaneGroup& group, const PositionBatch& batch, size_t base, const CountWeights& weights) {
+    __m256i material = _mm256_setzero_si256();
+    __m256i vector_x[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+    __m256i vector_y[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+    for (int piece = WP; piece <= BK; ++piece) {
+        __m256i counts = popcount_lanes(&batch.bitboards[piece][base]);
+        material = _mm256_add_epi32(material, _mm256_mullo_epi32(counts, _mm256_set1_epi32(weights.material[piece])));
+        for (int side = 0; side < 2; ++side) {
+            vector_x[side] = _mm256_add_epi32(vector_x[side], _mm256_mullo_epi32(counts, _mm256_set1_epi32(weights.vector_x[side][piece])));
+            vector_y[side] = _mm256_add_epi32(vector_y[side], _mm256_mullo_epi32(counts, _mm256_set1_epi32(weights.vector_y[side][piece])));
+        }
+    }
+    
+    __m128i side_bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&batch.white_to_move[base]));
+    __m256i white = _mm256_cmpgt_epi32(_mm256_cvtepu8_epi32(side_bytes), _mm256_setzero_si256());
+    store_whole_components(group.material, material);
+    store_whole_components(group.vector_x, _mm256_blendv_epi8(vector_x[1], vector_x[0], white));
+    store_whole_components(group.vector_y, _mm256_blendv_epi8(vector_y[1], vector_y[0], white));
+}
+#else
+// A whole number in the backend's format: integer scaling in fixed point never rounds
+Multivector2D::Component whole_component(int32_t value) {
+#if defined(FIXED_POINT_EVAL)
+    return value * FIXED_POINT_SCALE;
+#else
+    return static_cast<float>(value);
+#endif
+}
+
+void add_counts(LaneGroup& group, const PositionBatch& batch, size_t base, const CountWeights& weights) {
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        size_t i = base + lane;
+        int side = batch.white_to_move[i] ? 0 : 1;
+        int32_t material = 0;
+        int32_t vector_x = 0;
+        int32_t vector_y = 0;
+        for (int piece = WP; piece <= BK; ++piece) {
+            int32_t count = __builtin_popcountll(batch.bitboards[piece][i]);
+            material += count * weights.material[piece];
+            vector_x += count * weights.vector_x[side][piece];
+            vector_y += count * weights.vector_y[side][piece];
+        }
+        
+        group.material[lane] = whole_component(material);
+        group.vector_x[lane] = whole_component(vector_x);
+        group.vector_y[lane] = whole_component(vector_y);
+    }
+}
+#endif
+
+// Folds the slider rows into the bivector sums, in row order
+#if defined(FIXED_POINT_EVAL) && defined(__AVX2__)
+void accumulate(LaneGroup& group) {
+    __m256i bivector = _mm256_setzero_si256();
+    for (int step = 0; step < SLIDER_TYPES; ++step) {
+        __m256i mobility = _mm256_load_si256(reinterpret_cast<const __m256i*>(group.mobility[step]));
+        __m256i magnitudes = _mm256_mullo_epi32(mobility, _mm256_set1_epi32(FIXED_POINT_SCALE / 14));
+        bivector = _mm256_add_epi32(bivector, _mm256_mullo_epi32(magnitudes, _mm256_set1_epi32(group.weights[step])));
+    }
+    
+    _mm256_store_si256(reinterpret_cast<__m256i*>(group.bivectors), bivector);
+}
+#elif defined(__AVX2__)
+// Rounds exactly like slider_influence and Multivector2D::fma: a correctly rounded division,
+// then fused when the build has FMA, separate otherwise
+void accumulate(LaneGroup& group) {
+    __m256 bivector = _mm256_setzero_ps();
+    for (int step = 0; step < SLIDER_TYPES; ++step) {
+        __m256i mobility = _mm256_load_si256(reinterpret_cast<const __m256i*>(group.mobility[step]));
+        __m256 magnitudes = _mm256_div_ps(_mm256_cvtepi32_ps(mobility), _mm256_set1_ps(14.0f));
+        __m256 weight = _mm256_set1_ps(group.weights[step]);
+#if defined(__FMA__)
+        bivector = _mm256_fmadd_ps(magnitudes, weight, bivector);
+#else
+        bivector = _mm256_add_ps(bivector, _mm256_mul_ps(magnitudes, weight));
+#endif
+    }
+    
+    _mm256_store_ps(group.bivectors, bivector);
+}
+#else
+// A slider type's mobility is its summed attack count / 14, as GeometricEvaluator::slider_influence computes it
+Multivector2D::Component slider_magnitude(int attack_count) {
+#if defined(FIXED_POINT_EVAL)
+    return attack_count * (FIXED_POINT_SCALE / 14);
+#else
+    return static_cast<float>(attack_count) / 14.0f;
+#endif
+}
+
+void accumulate(LaneGroup& group) {
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        Multivector2D::Component bivector = 0;
+        for (int step = 0; step < SLIDER_TYPES; ++step) {
+            Multivector2D::Component magnitude = slider_magnitude(group.mobility[step][lane]);
+#if defined(__FMA__) && !defined(FIXED_POINT_EVAL)
+            bivector = std::fma(magnitude, group.weights[step], bivector);
+#else
+            bivector = bivector + magnitude * group.weights[step];
+#endif
+        }
+        group.bivectors[lane] = bivector;
+    }
+}
+#endif
+
+}
+
+void PositionBatch::assign(const Board* boards, size_t count) {
+    this->count = count;
+    size_t padded = (count + LANES - 1) / LANES * LANES;
+    
+    for (auto& piece_bitboards : bitboards) {
+        piece_bitboards.assign(padded, 0ULL);
+    }
+    occupancy.assign(padded, 0ULL);
+    white_to_move.assign(padded, 0);
+    
+    for (size_t i = 0; i < count; ++i) {
+        for (int piece = WP; piece <= BK; ++piece) {
+            bitboards[piece][i] = boards[i].bitboards[piece];
+        }
+        occupancy[i] = boards[i].all_pieces;
+        white_to_move[i] = boards[i].side_to_move;
+    }
+}
+
+void GeometricEvaluator::evaluate_batch(const PositionBatch& batch, Multivector2D* results) {
+    // Piece weights and table entries are whole numbers, so every count term is exact integer math
+    CountWeights count_weights;
+    for (int piece = WP; piece <= BK; ++piece) {
+        int32_t weight = static_cast<int32_t>(get_piece_weight(static_cast<Piece>(piece)));
+        count_weights.material[piece] = weight;
+        for (int side = 0; side < 2; ++side) {
+            InfluenceTerm influence = fixed_influence(piece, side == 0);
+            count_weights.vector_x[side][piece] = weight * static_cast<int32_t>(influence.x);
+            count_weights.vector_y[side][piece] = weight * static_cast<int32_t>(influence.y);
+        }
+    }
+    
+    for (size_t base = 0; base < batch.size(); base += LANES) {
+        LaneGroup group;
+        size_t lanes = std::min(LANES, batch.size() - base);
+        add_counts(group, batch, base, count_weights);
+        
+        // Float slider terms are rounded, so every lane adds them in evaluate_position's order,
+        // by piece type. Lanes without a piece of the type add zero.
+        for (int step = 0; step < SLIDER_TYPES; ++step) {
+            Piece piece = SLIDERS[step];
+            group.weights[step] = static_cast<Multivector2D::Component>(get_piece_weight(piece));
+            
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                uint64_t pieces = batch.bitboards[piece][base + lane];
+                uint64_t orthogonal = piece % 6 == WB ? 0ULL : pieces;
+                uint64_t diagonal = piece % 6 == WR ? 0ULL : pieces;
+                group.mobility[step][lane] = KoggeStone::slider_mobility(orthogonal, diagonal, batch.occupancy[base + lane]);
+            }
+        }
+        
+        accumulate(group);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            results[base + lane] = lane_result(group, lane);
+        }
+    }
+}
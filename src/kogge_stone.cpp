@@ -0,0 +1,151 @@
+#include "kogge_stone.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+const uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;
+const uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;
+
+// Positive directions shift left, negative ones right; the wrap mask drops squares
+// that would cross from the h-file to the a-file (or back)
+static uint64_t fill_left(uint64_t generators, uint64_t propagators, int shift) {
+    generators |= propagators & (generators << shift);
+    propagators &= propagators << shift;
+    generators |= propagators & (generators << (2 * shift));
+    propagators &= propagators << (2 * shift);
+    generators |= propagators & (generators << (4 * shift));
+    return generators;
+}
+
+static uint64_t fill_right(uint64_t generators, uint64_t propagators, int shift) {
+    generators |= propagators & (generators >> shift);
+    propagators &= propagators >> shift;
+    generators |= propagators & (generators >> (2 * shift));
+    propagators &= propagators >> (2 * shift);
+    generators |= propagators & (generators >> (4 * shift));
+    return generators;
+}
+
+static uint64_t attacks_left(uint64_t sliders, uint64_t empty, int shift, uint64_t wrap) {
+    return (fill_left(sliders, empty & wrap, shift) << shift) & wrap;
+}
+
+static uint64_t attacks_right(uint64_t sliders, uint64_t empty, int shift, uint64_t wrap) {
+    return (fill_right(sliders, empty & wrap, shift) >> shift) & wrap;
+}
+
+uint64_t KoggeStone::slider_attacks(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy) {
+#if defined(__AVX2__)
+    return slider_attacks_avx2(orthogonal, diagonal, occupancy);
+#else
+    return slider_attacks_scalar(orthogonal, diagonal, occupancy);
+#endif
+}
+
+int KoggeStone::slider_mobility(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy) {
+#if defined(__AVX2__)
+    return slider_mobility_avx2(orthogonal, diagonal, occupancy);
+#else
+    return slider_mobility_scalar(orthogonal, diagonal, occupancy);
+#endif
+}
+
+uint64_t KoggeStone::rook_attacks(uint64_t rooks, uint64_t occupancy) {
+    return slider_attacks(rooks, 0ULL, occupancy);
+}
+
+uint64_t KoggeStone::bishop_attacks(uint64_t bishops, uint64_t occupancy) {
+    return slider_attacks(0ULL, bishops, occupancy);
+}
+
+uint64_t KoggeStone::slider_attacks_scalar(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy) {
+    uint64_t empty = ~occupancy;
+    
+    return attacks_left(orthogonal, empty, 8, ~0ULL) |       // north
+           attacks_right(orthogonal, empty, 8, ~0ULL) |      // south
+           attacks_left(orthogonal, empty, 1, NOT_A_FILE) |  // east
+           attacks_right(orthogonal, empty, 1, NOT_H_FILE) | // west
+           attacks_left(diagonal, empty, 9, NOT_A_FILE) |    // north-east
+           attacks_left(diagonal, empty, 7, NOT_H_FILE) |    // north-west
+           attacks_right(diagonal, empty, 9, NOT_H_FILE) |   // south-west
+           attacks_right(diagonal, empty, 7, NOT_A_FILE);    // south-east
+}
+
+int KoggeStone::slider_mobility_scalar(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy) {
+    uint64_t empty = ~occupancy;
+    
+    return __builtin_popcountll(attacks_left(orthogonal, empty, 8, ~0ULL)) +
+           __builtin_popcountll(attacks_right(orthogonal, empty, 8, ~0ULL)) +
+           __builtin_popcountll(attacks_left(orthogonal, empty, 1, NOT_A_FILE)) +
+           __builtin_popcountll(attacks_right(orthogonal, empty, 1, NOT_H_FILE)) +
+           __builtin_popcountll(attacks_left(diagonal, empty, 9, NOT_A_FILE)) +
+           __builtin_popcountll(attacks_left(diagonal, empty, 7, NOT_H_FILE)) +
+           __builtin_popcountll(attacks_right(diagonal, empty, 9, NOT_H_FILE)) +
+           __builtin_popcountll(attacks_right(diagonal, empty, 7, NOT_A_FILE));
+}
+
+#if defined(__AVX2__)
+// Attacks of all eight directions, one per 64-bit lane: the left-shifting four in left,
+// the right-shifting four in right
+static void directional_attacks(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy, __m256i& left, __m256i& right) {
+    // Lanes: north/south, east/west, north-east/south-west, north-west/south-east
+    const __m256i shifts = _mm256_setr_epi64x(8, 1, 9, 7);
+    const __m256i shifts2 = _mm256_slli_epi64(shifts, 1);
+    const __m256i shifts4 = _mm256_slli_epi64(shifts, 2);
+    const __m256i left_wrap = _mm256_setr_epi64x(-1, NOT_A_FILE, NOT_A_FILE, NOT_H_FILE);
+    const __m256i right_wrap = _mm256_setr_epi64x(-1, NOT_H_FILE, NOT_H_FILE, NOT_A_FILE);
+    
+    __m256i sliders = _mm256_setr_epi64x(orthogonal, orthogonal, diagonal, diagonal);
+    __m256i empty = _mm256_set1_epi64x(~occupancy);
+    
+    __m256i generators = sliders;
+    __m256i propagators = _mm256_and_si256(empty, left_wrap);
+    generators = _mm256_or_si256(generators, _mm256_and_si256(propagators, _mm256_sllv_epi64(generators, shifts)));
+    propagators = _mm256_and_si256(propagators, _mm256_sllv_epi64(propagators, shifts));
+    generators = _mm256_or_si256(generators, _mm256_and_si256(propagators, _mm256_sllv_epi64(generators, shifts2)));
+    propagators = _mm256_and_si256(propagators, _mm256_sllv_epi64(propagators, shifts2));
+    generators = _mm256_or_si256(generators, _mm256_and_si256(propagators, _mm256_sllv_epi64(generators, shifts4)));
+    left = _mm256_and_si256(_mm256_sllv_epi64(generators, shifts), left_wrap);
+    
+    generators = sliders;
+    propagators = _mm256_and_si256(empty, right_wrap);
+    generators = _mm256_or_si256(generators, _mm256_and_si256(propagators, _mm256_srlv_epi64(generators, shifts)));
+    propagators = _mm256_and_si256(propagators, _mm256_srlv_epi64(propagators, shifts));
+    generators = _mm256_or_si256(generators, _mm256_and_si256(propagators, _mm256_srlv_epi64(generators, shifts2)));
+    propagators = _mm256_and_si256(propagators, _mm256_srlv_epi64(propagators, shifts2));
+    generators = _mm256_or_si256(generators, _mm256_and_si256(propagators, _mm256_srlv_epi64(generators, shifts4)));
+    right = _mm256_and_si256(_mm256_srlv_epi64(generators, shifts), right_wrap);
+}
+
+uint64_t KoggeStone::slider_attacks_avx2(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy) {
+    __m256i left, right;
+    directional_attacks(orthogonal, diagonal, occupancy, left, right);
+    
+    // Fold the eight lanes into one bitboard
+    __m256i attacks = _mm256_or_si256(left, right);
+    __m128i folded = _mm_or_si128(_mm256_castsi256_si128(attacks), _mm256_extracti128_si256(attacks, 1));
+    folded = _mm_or_si128(folded, _mm_unpackhi_epi64(folded, folded));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(folded));
+}
+
+int KoggeStone::slider_mobility_avx2(uint64_t orthogonal, uint64_t diagonal, uint64_t occupancy) {
+    __m256i left, right;
+    directional_attacks(orthogonal, diagonal, occupancy, left, right);
+    
+    // Byte popcounts from a nibble table, summed per lane by sad against zero
+    const __m256i nibble_counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                   0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(
+        _mm256_add_epi8(_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(left, low_nibbles)),
+                        _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi64(left, 4), low_nibbles))),
+        _mm256_add_epi8(_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(right, low_nibbles)),
+                        _mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi64(right, 4), low_nibbles))));
+    __m256i counts = _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+    
+    __m128i folded = _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+    folded = _mm_add_epi64(folded, _mm_unpackhi_epi64(folded, folded));
+    return static_cast<int>(_mm_cvtsi128_si64(folded));
+}
+#endif
@@ -1,29 +1,23 @@
 #include "magic_bitboards.h"
-#include <random>
-#include <vector>
-#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 std::array<MagicBitboards::MagicEntry, 64> MagicBitboards::rook_magics;
 std::array<MagicBitboards::MagicEntry, 64> MagicBitboards::bishop_magics;
+alignas(64) uint64_t MagicBitboards::attack_table[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE];
 
 void MagicBitboards::init() {
-    init_magic_entries();
-}
-
-uint64_t MagicBitboards::get_rook_attacks(int square, uint64_t blockers) {
-    const MagicEntry& entry = rook_magics[square];
-    blockers &= entry.mask;
-    blockers *= entry.magic;
-    blockers >>= entry.shift;
-    return entry.attacks[blockers];
-}
-
-uint64_t MagicBitboards::get_bishop_attacks(int square, uint64_t blockers) {
-    const MagicEntry& entry = bishop_magics[square];
-    blockers &= entry.mask;
-    blockers *= entry.magic;
-    blockers >>= entry.shift;
-    return entry.attacks[blockers];
+#if defined(USE_PEXT)
+    if (!__builtin_cpu_supports("bmi2")) {
+        std::cerr << "This build uses PEXT slider lookups but the CPU has no BMI2 support" << std::endl;
+        std::abort();
+    }
+#endif
+    
+    // Function-local static: runs exactly once, even if boards are built concurrently
+    static const bool initialized = (init_magic_entries(), true);
+    (void)initialized;
 }
 
 uint64_t MagicBitboards::generate_blocker_mask(int square, bool is_rook) {
@@ -108,97 +102,41 @@ uint64_t MagicBitboards::generate_attack_mask(int square, uint64_t blockers, boo
     return attacks;
 }
 
-bool MagicBitboards::verify_magic_number(uint64_t magic, int square, bool is_rook) {
-    uint64_t mask = generate_blocker_mask(square, is_rook);
-    int bits = __builtin_popcountll(mask);
-    std::vector<uint64_t> blockers;
-    std::vector<uint64_t> attacks;
-    
-    // Gerar todas as combinações possíveis de bloqueadores
-    for (uint64_t i = 0; i < (1ULL << bits); i++) {
-        uint64_t blocker = 0;
-        uint64_t temp_mask = mask;
-        for (int j = 0; j < bits; j++) {
-            int lsb = __builtin_ctzll(temp_mask);
-            if (i & (1ULL << j)) blocker |= 1ULL << lsb;
-            temp_mask &= temp_mask - 1;
-        }
-        blockers.push_back(blocker);
-        attacks.push_back(generate_attack_mask(square, blocker, is_rook));
-    }
+uint64_t* MagicBitboards::fill_attack_table(MagicEntry& entry, uint64_t* table, int square, bool is_rook) {
+    entry.mask = generate_blocker_mask(square, is_rook);
+    entry.magic = is_rook ? ROOK_MAGICS[square] : BISHOP_MAGICS[square];
+#if defined(USE_PEXT)
+    entry.shift = 64 - __builtin_popcountll(entry.mask);
+#else
+    entry.shift = is_rook ? ROOK_SHIFTS[square] : BISHOP_SHIFTS[square];
+#endif
+    entry.attacks = table;
     
-    // Verificar se o número mágico gera índices únicos
-    std::vector<uint64_t> indices;
-    for (uint64_t blocker : blockers) {
-        uint64_t index = (blocker * magic) >> (64 - bits);
-        if (std::find(indices.begin(), indices.end(), index) != indices.end()) {
-            return false;
-        }
-        indices.push_back(index);
-    }
+    // Enumerate every blocker subset of the mask (Carry-Rippler)
+    uint64_t blocker = 0;
+    do {
+        uint64_t attacks = generate_attack_mask(square, blocker, is_rook);
+        uint64_t& slot = table[attack_index(entry, blocker)];
+        
+        // Slider attacks are never empty, so a non-zero slot that differs is a destructive collision
+        assert(slot == 0 || slot == attacks);
+        slot = attacks;
+        
+        blocker = (blocker - entry.mask) & entry.mask;
+    } while (blocker);
     
-    return true;
+    return table + (1ULL << (64 - entry.shift));
 }
 
-uint64_t MagicBitboards::find_magic_number(int square, bool is_rook) {
-    uint64_t mask = generate_blocker_mask(square, is_rook);
-    int bits = __builtin_popcountll(mask);
-    
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dis;
+void MagicBitboards::init_magic_entries() {
+    uint64_t* rook_table = attack_table;
+    uint64_t* bishop_table = attack_table + ROOK_TABLE_SIZE;
     
-    for (int i = 0; i < 100000000; i++) {
-        uint64_t magic = dis(gen) & dis(gen) & dis(gen);
-        if (verify_magic_number(magic, square, is_rook)) {
-            return magic;
-        }
+    for (int square = 0; square < 64; square++) {
+        rook_table = fill_attack_table(rook_magics[square], rook_table, square, true);
+        bishop_table = fill_attack_table(bishop_magics[square], bishop_table, square, false);
     }
     
-    return 0; // Falha ao encontrar número mágico
+    assert(rook_table == attack_table + ROOK_TABLE_SIZE);
+    assert(bishop_table == attack_table + ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE);
 }
-
-void MagicBitboards::init_magic_entries() {
-    for (int square = 0; square < 64; square++) {
-        // Inicializar torres
-        rook_magics[square].magic = ROOK_MAGICS[square];
-        rook_magics[square].mask = generate_blocker_mask(square, true);
-        rook_magics[square].shift = 64 - __builtin_popcountll(rook_magics[square].mask);
-        rook_magics[square].attacks = new uint64_t[1ULL << __builtin_popcountll(rook_magics[square].mask)];
-        
-        // Inicializar bispos
-        bishop_magics[square].magic = BISHOP_MAGICS[square];
-        bishop_magics[square].mask = generate_blocker_mask(square, false);
-        bishop_magics[square].shift = 64 - __builtin_popcountll(bishop_magics[square].mask);
-        bishop_magics[square].attacks = new uint64_t[1ULL << __builtin_popcountll(bishop_magics[square].mask)];
-        
-        // Preencher tabelas de ataque
-        uint64_t mask = rook_magics[square].mask;
-        int bits = __builtin_popcountll(mask);
-        for (uint64_t i = 0; i < (1ULL << bits); i++) {
-            uint64_t blocker = 0;
-            uint64_t temp_mask = mask;
-            for (int j = 0; j < bits; j++) {
-                int lsb = __builtin_ctzll(temp_mask);
-                if (i & (1ULL << j)) blocker |= 1ULL << lsb;
-                temp_mask &= temp_mask - 1;
-            }
-            uint64_t index = (blocker * rook_magics[square].magic) >> rook_magics[square].shift;
-            rook_magics[square].attacks[index] = generate_attack_mask(square, blocker, true);
-        }
-        
-        mask = bishop_magics[square].mask;
-        bits = __builtin_popcountll(mask);
-        for (uint64_t i = 0; i < (1ULL << bits); i++) {
-            uint64_t blocker = 0;
-            uint64_t temp_mask = mask;
-            for (int j = 0; j < bits; j++) {
-                int lsb = __builtin_ctzll(temp_mask);
-                if (i & (1ULL << j)) blocker |= 1ULL << lsb;
-                temp_mask &= temp_mask - 1;
-            }
-            uint64_t index = (blocker * bishop_magics[square].magic) >> bishop_magics[square].shift;
-            bishop_magics[square].attacks[index] = generate_attack_mask(square, blocker, false);
-        }
-    }
-} 
\ No newline at end of file
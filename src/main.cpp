@@ -1,8 +1,11 @@
 #include <iostream>
 #include <string>
 #include <iomanip>
+#include <cstdlib>
 #include "GeometricState.h"
 #include "bitboard.h"
+#include "search.h"
+#include "uci.h"
 
 void print_bitboard(uint64_t bitboard) {
     for (int rank = 7; rank >= 0; rank--) {
@@ -49,18 +52,81 @@ std::string piece_to_string(Piece piece) {
 void print_moves(const MoveList& moves) {
     std::cout << "Generated " << moves.size() << " pawn moves:" << std::endl;
     for (const auto& move : moves) {
-        std::cout << square_to_string(move.from) << " -> " 
-                  << square_to_string(move.to) << " (" 
-                  << move_type_to_string(move.type);
-        if (move.type == PROMOTION) {
-            std::cout << " to " << piece_to_string(move.promotion_piece);
+        std::cout << square_to_string(move.from()) << " -> " 
+                  << square_to_string(move.to()) << " (" 
+                  << move_type_to_string(move.type());
+        if (move.type() == PROMOTION) {
+            std::cout << " to " << piece_to_string(move.promotion_piece());
         }
         std::cout << ")" << std::endl;
     }
     std::cout << std::endl;
 }
 
-int main() {
+// quantum_chess search [--threads N] [--hash MB] [depth] [fen]
+int run_search(int argc, char* argv[]) {
+    int depth = 8;
+    int threads = 1;
+    size_t hash_mb = 64;
+    std::string fen;
+    
+    int arg = 2;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        std::string option = argv[arg];
+        if (option == "--threads") {
+            threads = std::atoi(argv[arg + 1]);
+        } else if (option == "--hash") {
+            hash_mb = static_cast<size_t>(std::atoi(argv[arg + 1]));
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    if (arg < argc) {
+        depth = std::atoi(argv[arg++]);
+    }
+    for (; arg < argc; arg++) {
+        fen += (fen.empty() ? "" : " ") + std::string(argv[arg]);
+    }
+    
+    Board board;
+    if (!fen.empty()) {
+        FenError error = board.load_fen(fen);
+        if (error != FenError::NONE) {
+            std::cerr << "Invalid FEN: " << Board::fen_error_message(error) << std::endl;
+            return 1;
+        }
+    }
+    
+    SearchLimits limits;
+    limits.depth = depth;
+    
+    TranspositionTable table(hash_mb);
+    Search search(table, threads);
+    Move best_move = search.think(board, limits, [](const SearchReport& report) {
+        std::cout << "depth " << report.depth << " score cp " << report.score
+                  << " nodes " << report.nodes << " nps " << report.nps
+                  << " time " << report.time_ms << " pv";
+        for (const Move& move : report.pv) {
+            std::cout << " " << Board::move_to_string(move);
+        }
+        std::cout << std::endl;
+    });
+    
+    std::cout << "bestmove " << Board::move_to_string(best_move) << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "search") {
+        return run_search(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "uci") {
+        UciEngine engine(std::cin, std::cout);
+        engine.loop();
+        return 0;
+    }
+    
     std::cout << "=== Quantum Chess Pawn Move Generation ===" << std::endl << std::endl;
     
     Board starting_board;
@@ -71,23 +137,23 @@ int main() {
     print_moves(moves);
     
     moves.clear();
-    Board en_passant_board("rnbqkbnr/pp1ppppp/8/2pP4/8/8/PPP1PPPP/RNBQKBNR w KQkq c6 0 3");
+    Board en_passant_board = Board::from_fen("rnbqkbnr/pp1ppppp/8/2pP4/8/8/PPP1PPPP/RNBQKBNR w KQkq c6 0 3").value();
     std::cout << "Testing en passant position:" << std::endl;
     std::cout << "En passant square: " << en_passant_board.en_passant_square << std::endl;
     en_passant_board.generate_pawn_moves(moves);
     print_moves(moves);
     
     moves.clear();
-    Board promotion_board("rnbqkbnr/ppppppPp/8/8/8/8/PPPPPPP1/RNBQKBNR w KQkq - 0 1");
+    Board promotion_board = Board::from_fen("rnbqkbnr/ppppppPp/8/8/8/8/PPPPPPP1/RNBQKBNR w KQkq - 0 1").value();
     std::cout << "Testing promotion position (White pawn on g7):" << std::endl;
     promotion_board.generate_pawn_moves(moves);
     print_moves(moves);
     
     moves.clear();
-    Board black_moves_board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1");
+    Board black_moves_board = Board::from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1").value();
     std::cout << "Testing starting position (Black to move):" << std::endl;
     black_moves_board.generate_pawn_moves(moves);
     print_moves(moves);
-
+    
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "move_picker.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Victim and attacker values for MVV-LVA, indexed by piece % 6
+const int mvv_lva_value[6] = {1, 3, 3, 5, 9, 0};
+
+const ScoredMove& ScoredMoveList::pick_best(size_t index) {
+    size_t best = index;
+    for (size_t i = index + 1; i < count; ++i) {
+        if (moves[i].score > moves[best].score) {
+            best = i;
+        }
+    }
+    
+    std::swap(moves[index], moves[best]);
+    return moves[index];
+}
+
+void SearchHeuristics::clear() {
+    std::fill(&history[0][0], &history[0][0] + 12 * 64, 0);
+    std::fill(&butterfly[0][0][0], &butterfly[0][0][0] + 2 * 64 * 64, 0);
+    std::fill(&countermoves[0][0], &countermoves[0][0] + 12 * 64, Move());
+}
+
+int SearchHeuristics::quiet_score(const Board& board, const Move& move) const {
+    int side = board.side_to_move ? WHITE : BLACK;
+    return history[board.piece_on[move.from()]][move.to()] + butterfly[side][move.from()][move.to()];
+}
+
+void SearchHeuristics::update_history(const Board& board, const Move& move, int bonus) {
+    bonus = std::max(-MAX_HISTORY, std::min(bonus, MAX_HISTORY));
+    int side = board.side_to_move ? WHITE : BLACK;
+    
+    // Gravity: the closer an entry already is to the limit, the less a bonus moves it
+    int& piece_to = history[board.piece_on[move.from()]][move.to()];
+    piece_to += bonus - piece_to * std::abs(bonus) / MAX_HISTORY;
+    int& from_to = butterfly[side][move.from()][move.to()];
+    from_to += bonus - from_to * std::abs(bonus) / MAX_HISTORY;
+}
+
+MovePicker::MovePicker(Board& board, Move hash_move, const Move* killers,
+                       const SearchHeuristics* heuristics, Move countermove)
+    : board(board), hash_move(hash_move), countermove(countermove), heuristics(heuristics),
+      stage(HASH_MOVE), captures_only(false), current(0), killer_index(0) {
+    for (int i = 0; i < MAX_KILLERS; ++i) {
+        this->killers[i] = killers ? killers[i] : Move();
+    }
+}
+
+MovePicker::MovePicker(Board& board)
+    : board(board), heuristics(nullptr), stage(GENERATE_CAPTURES), captures_only(true),
+      current(0), killer_index(0) {
+}
+
+Move MovePicker::next_move() {
+    switch (stage) {
+        case HASH_MOVE:
+            stage = GENERATE_CAPTURES;
+            if (hash_move != Move() && board.is_legal(hash_move)) {
+                return hash_move;
+            }
+            [[fallthrough]];
+        
+        case GENERATE_CAPTURES: {
+            MoveList move_list;
+            board.generate_captures(move_list);
+            load_stage(move_list, true);
+            stage = CAPTURES;
+            [[fallthrough]];
+        }
+        
+        case CAPTURES:
+            while (current < moves.size()) {
+                Move move = moves.pick_best(current++).move;
+                if (move != hash_move) {
+                    return move;
+                }
+            }
+            if (captures_only) {
+                stage = DONE;
+                break;
+            }
+            stage = KILLERS;
+            [[fallthrough]];
+        
+        case KILLERS:
+            while (killer_index < MAX_KILLERS) {
+                Move killer = killers[killer_index++];
+                
+                bool duplicate = std::find(killers, killers + killer_index - 1, killer) != killers + killer_index - 1;
+                if (!duplicate && is_quiet_candidate(killer)) {
+                    return killer;
+                }
+            }
+            stage = COUNTERMOVE;
+            [[fallthrough]];
+        
+        case COUNTERMOVE:
+            stage = GENERATE_QUIETS;
+            if (!is_killer(countermove) && is_quiet_candidate(countermove)) {
+                return countermove;
+            }
+            [[fallthrough]];
+        
+        case GENERATE_QUIETS: {
+            MoveList move_list;
+            board.generate_quiets(move_list);
+            load_stage(move_list, false);
+            stage = QUIETS;
+            [[fallthrough]];
+        }
+        
+        case QUIETS:
+            while (current < moves.size()) {
+                Move move = moves.pick_best(current++).move;
+                if (move != hash_move && move != countermove && !is_killer(move)) {
+                    return move;
+                }
+            }
+            stage = DONE;
+            [[fallthrough]];
+        
+        case DONE:
+            break;
+    }
+    
+    return Move();
+}
+
+void MovePicker::load_stage(const MoveList& move_list, bool captures) {
+    moves.clear();
+    current = 0;
+    
+    for (const Move& move : move_list) {
+        int score = 0;
+        
+        if (captures) {
+            score = capture_score(move);
+        } else if (heuristics) {
+            score = heuristics->quiet_score(board, move);
+        }
+        
+        moves.push_back(move, score);
+    }
+}
+
+int MovePicker::capture_score(const Move& move) const {
+    Piece attacker = board.piece_on[move.from()];
+    Piece victim = move.type() == EN_PASSANT ? WP : board.piece_on[move.to()];
+    
+    int score = victim == NO_PIECE ? 0 : mvv_lva_value[victim % 6] * 16 - mvv_lva_value[attacker % 6];
+    if (move.type() == PROMOTION) {
+        score += mvv_lva_value[move.promotion_piece() % 6] * 16;
+    }
+    
+    return score;
+}
+
+// Killers and countermoves come from other nodes, so only quiet moves that are legal here qualify
+bool MovePicker::is_quiet_candidate(const Move& move) const {
+    bool quiet = move.type() != PROMOTION && move.type() != EN_PASSANT && board.piece_on[move.to()] == NO_PIECE;
+    return move != Move() && move != hash_move && quiet && board.is_legal(move);
+}
+
+bool MovePicker::is_killer(const Move& move) const {
+    for (const Move& killer : killers) {
+        if (move == killer) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,458 @@
+#include "search.h"
+#include "geometric_evaluator.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+
+// Helper i searches depth d only when ((d + SKIP_PHASE[i]) / SKIP_SIZE[i]) is even,
+// so at any moment the helpers are spread over several depths instead of racing on one
+const int SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+const int SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// Victim values for delta pruning, indexed by piece % 6, and the positional slack allowed on top
+const int QSEARCH_PIECE_VALUE[6] = {100, 300, 300, 500, 900, 0};
+const int DELTA_MARGIN = 200;
+
+// Every iteration depth fits the table's depth field; only check extensions beyond it are clamped
+static_assert(Search::MAX_PLY - 1 <= TranspositionTable::MAX_DEPTH, "iteration depths must fit a TT entry");
+
+Search::Search(TranspositionTable& table, int threads) : table(table), stopped(false) {
+    // Late moves at high depth are reduced the most
+    for (int depth = 0; depth < 64; ++depth) {
+        for (int move_count = 0; move_count < 64; ++move_count) {
+            reductions[depth][move_count] = (depth == 0 || move_count == 0)
+                ? 0
+                : static_cast<int>(0.75 + std::log(depth) * std::log(move_count) / 2.25);
+        }
+    }
+    
+    set_threads(threads);
+}
+
+Search::~Search() = default;
+
+void Search::set_threads(int threads) {
+    workers.clear();
+    for (int i = 0; i < std::max(1, threads); ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->id = i;
+    }
+}
+
+uint64_t Search::total_nodes() const {
+    uint64_t nodes = 0;
+    for (const auto& worker : workers) {
+        nodes += worker->nodes.load(std::memory_order_relaxed);
+    }
+    return nodes;
+}
+
+// Centipawns from the side to move's point of view
+static int to_centipawns(const Board& board, const Multivector2D& m_total) {
+    int centipawns = static_cast<int>(GeometricEvaluator::get_final_score(m_total) * 100.0f);
+    return board.side_to_move ? centipawns : -centipawns;
+}
+
+int Search::evaluate(const Board& board) {
+    return to_centipawns(board, GeometricEvaluator::evaluate_position(board));
+}
+
+int Search::evaluate(const Worker& worker) {
+    return to_centipawns(worker.board, worker.accumulator.value(worker.board));
+}
+
+void Search::make_move(Worker& worker, const Move& move, int ply) {
+    assert(ply < MAX_PLY);
+    worker.board.make_move(move, worker.undo[ply]);
+    worker.accumulator.push(worker.board);
+}
+
+void Search::unmake_move(Worker& worker) {
+    worker.board.unmake_move();
+    worker.accumulator.pop();
+}
+
+Move Search::think(const Board& board, const SearchLimits& limits, const Reporter& reporter) {
+    this->limits = limits;
+    start_time = std::chrono::steady_clock::now();
+    stopped.store(false, std::memory_order_relaxed);
+    table.new_search();
+    
+    for (auto& worker : workers) {
+        worker->board = board;
+        worker->nodes.store(0, std::memory_order_relaxed);
+        worker->best_move = Move();
+        for (auto& ply_killers : worker->killers) {
+            std::fill(std::begin(ply_killers), std::end(ply_killers), Move());
+        }
+        worker->heuristics.clear();
+        worker->accumulator.reset(board);
+    }
+    
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < workers.size(); ++i) {
+        helpers.emplace_back(&Search::iterate, this, std::ref(*workers[i]), nullptr);
+    }
+    
+    iterate(*workers[0], reporter ? &reporter : nullptr);
+    
+    while (limits.infinite && !stopped.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    // Helpers never finish on their own before the main thread; release them now
+    stop();
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+    
+    Move best_move = workers[0]->best_move;
+    
+    // Stopped inside the first iteration: any legal move beats none
+    if (best_move == Move()) {
+        MoveList move_list;
+        workers[0]->board.generate_moves(move_list);
+        if (!move_list.empty()) {
+            best_move = move_list[0];
+        }
+    }
+    
+    return best_move;
+}
+
+void Search::iterate(Worker& worker, const Reporter* reporter) {
+    int max_depth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+    
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        if (worker.id > 0) {
+            int slot = (worker.id - 1) % 20;
+            if (((depth + SKIP_PHASE[slot]) / SKIP_SIZE[slot]) % 2) {
+                continue;
+            }
+        }
+        
+        int score = negamax(worker, depth, 0, -INFINITE_SCORE, INFINITE_SCORE, false);
+        
+        // A partial iteration is only trustworthy up to the move it was searching
+        if (stopped.load(std::memory_order_relaxed)) {
+            break;
+        }
+        
+        if (worker.pv_length[0] > 0) {
+            worker.best_move = worker.pv[0][0];
+        }
+        
+        if (reporter) {
+            int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start_time).count();
+            uint64_t nodes = total_nodes();
+            SearchReport report;
+            report.depth = depth;
+            report.score = score;
+            report.nodes = nodes;
+            report.nps = elapsed > 0 ? nodes * 1000 / elapsed : nodes * 1000;
+            report.time_ms = elapsed;
+            report.hashfull = table.hashfull();
+            report.pv.assign(worker.pv[0], worker.pv[0] + worker.pv_length[0]);
+            (*reporter)(report);
+        }
+        
+        // No point deepening once a forced mate or an empty move list has been found
+        if (worker.pv_length[0] == 0 || std::abs(score) >= MATE_BOUND) {
+            break;
+        }
+    }
+}
+
+int Search::negamax(Worker& worker, int depth, int ply, int alpha, int beta, bool allow_null) {
+    Board& board = worker.board;
+    worker.pv_length[ply] = 0;
+    
+    if (should_stop(worker)) {
+        return 0;
+    }
+    worker.nodes.store(worker.nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    
+    bool pv_node = beta - alpha > 1;
+    if (ply > 0 && (board.halfmove_clock >= 100 || board.is_repetition())) {
+        return 0;
+    }
+    if (ply >= MAX_PLY - 1) {
+        return evaluate(worker);
+    }
+    
+    // Reads the node's attack map, which move generation then reuses for king danger
+    bool in_check = board.in_check();
+    if (in_check) {
+        ++depth;
+    }
+    
+    if (depth <= 0) {
+        return qsearch(worker, ply, alpha, beta);
+    }
+    
+    TTData tt;
+    bool tt_hit = table.probe(board.hash_key, tt);
+    if (tt_hit && !pv_node && ply > 0 && tt.depth >= depth) {
+        int tt_score = score_from_tt(tt.score, ply);
+        if (tt.bound == BOUND_EXACT ||
+            (tt.bound == BOUND_LOWER && tt_score >= beta) ||
+            (tt.bound == BOUND_UPPER && tt_score <= alpha)) {
+            return tt_score;
+        }
+    }
+    
+    // Null move: if passing still fails high, a real move will too
+    if (allow_null && !pv_node && !in_check && depth >= 3 && has_non_pawn_material(board) &&
+        evaluate(worker) >= beta) {
+        int reduction = 2 + depth / 4;
+        board.make_null_move(worker.undo[ply]);
+        worker.accumulator.push(board);
+        int score = -negamax(worker, depth - 1 - reduction, ply + 1, -beta, -beta + 1, false);
+        board.unmake_null_move();
+        worker.accumulator.pop();
+        
+        if (stopped.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (score >= beta) {
+            return score >= MATE_BOUND ? beta : score;
+        }
+    }
+    
+    MovePicker picker(board, tt_hit ? tt.move : Move(), worker.killers[ply], &worker.heuristics,
+                      countermove_for(worker));
+    int original_alpha = alpha;
+    int best_score = -INFINITE_SCORE;
+    Move best_move;
+    int move_count = 0;
+    Move move;
+    Move tried_quiets[64];
+    int tried_count = 0;
+    
+    while ((move = picker.next_move()) != Move()) {
+        bool quiet = board.piece_on[move.to()] == NO_PIECE && move.type() != EN_PASSANT && move.type() != PROMOTION;
+        ++move_count;
+        
+        make_move(worker, move, ply);
+        int score;
+        
+        if (move_count == 1) {
+            score = -negamax(worker, depth - 1, ply + 1, -beta, -alpha, true);
+        } else {
+            // Late quiet moves are searched shallower first and only re-searched if they surprise
+            int reduction = 0;
+            if (depth >= 3 && move_count > 3 && quiet && !in_check) {
+                reduction = reductions[std::min(depth, 63)][std::min(move_count, 63)];
+                if (pv_node) {
+                    reduction -= 1;
+                }
+                reduction = std::max(0, std::min(reduction, depth - 2));
+            }
+            
+            score = -negamax(worker, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha, true);
+            if (score > alpha && reduction > 0) {
+                score = -negamax(worker, depth - 1, ply + 1, -alpha - 1, -alpha, true);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(worker, depth - 1, ply + 1, -beta, -alpha, true);
+            }
+        }
+        
+        unmake_move(worker);
+        
+        if (stopped.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        
+        if (score > best_score) {
+            best_score = score;
+            
+            if (score > alpha) {
+                alpha = score;
+                best_move = move;
+                worker.pv[ply][0] = move;
+                std::copy(worker.pv[ply + 1], worker.pv[ply + 1] + worker.pv_length[ply + 1], worker.pv[ply] + 1);
+                worker.pv_length[ply] = worker.pv_length[ply + 1] + 1;
+                
+                if (score >= beta) {
+                    if (quiet) {
+                        update_quiet_stats(worker, move, ply, depth, tried_quiets, tried_count);
+                    }
+                    break;
+                }
+            }
+        }
+        
+        if (quiet && tried_count < 64) {
+            tried_quiets[tried_count++] = move;
+        }
+    }
+    
+    if (move_count == 0) {
+        return in_check ? -MATE_SCORE + ply : 0;
+    }
+    
+    Bound bound = best_score >= beta ? BOUND_LOWER : best_score > original_alpha ? BOUND_EXACT : BOUND_UPPER;
+    table.store(board.hash_key, best_move, score_to_tt(best_score, ply), depth, bound);
+    
+    return best_score;
+}
+
+int Search::qsearch(Worker& worker, int ply, int alpha, int beta) {
+    Board& board = worker.board;
+    worker.pv_length[ply] = 0;
+    
+    if (should_stop(worker)) {
+        return 0;
+    }
+    worker.nodes.store(worker.nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    
+    if (ply >= MAX_PLY - 1) {
+        return evaluate(worker);
+    }
+    
+    // Reads the node's attack map, which move generation then reuses for king danger
+    bool in_check = board.in_check();
+    
+    // Stand pat: the side to move can usually do at least as well as the static score by
+    // declining every capture. In check that is not an option, so all evasions are tried.
+    int stand_pat = -INFINITE_SCORE;
+    if (!in_check) {
+        stand_pat = evaluate(worker);
+        if (stand_pat >= beta) {
+            return stand_pat;
+        }
+        alpha = std::max(alpha, stand_pat);
+    }
+    
+    MovePicker picker = in_check ? MovePicker(board, Move()) : MovePicker(board);
+    int best_score = stand_pat;
+    int move_count = 0;
+    Move move;
+    
+    while ((move = picker.next_move()) != Move()) {
+        ++move_count;
+        
+        if (!in_check) {
+            // Delta pruning: even winning the victim outright cannot lift the score to alpha
+            Piece victim = move.type() == EN_PASSANT ? WP : board.piece_on[move.to()];
+            int victim_value = victim == NO_PIECE ? 0 : QSEARCH_PIECE_VALUE[victim % 6];
+            if (move.type() != PROMOTION && stand_pat + victim_value + DELTA_MARGIN <= alpha) {
+                continue;
+            }
+            
+            // Captures that lose material once the exchange is resolved are not worth a node
+            if (board.see(move) < 0) {
+                continue;
+            }
+        }
+        
+        make_move(worker, move, ply);
+        int score = -qsearch(worker, ply + 1, -beta, -alpha);
+        unmake_move(worker);
+        
+        if (stopped.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                alpha = score;
+                if (score >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (in_check && move_count == 0) {
+        return -MATE_SCORE + ply;
+    }
+    
+    return best_score;
+}
+
+bool Search::should_stop(Worker& worker) {
+    if (stopped.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    
+    // Limits are polled every 1024 nodes per thread; the node limit counts all threads
+    if ((worker.nodes.load(std::memory_order_relaxed) & 1023) != 0) {
+        return false;
+    }
+    
+    if (limits.nodes && total_nodes() >= limits.nodes) {
+        stop();
+    } else if (limits.time_ms) {
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time).count();
+        if (elapsed >= limits.time_ms) {
+            stop();
+        }
+    }
+    
+    return stopped.load(std::memory_order_relaxed);
+}
+
+bool Search::has_non_pawn_material(const Board& board) {
+    // Zugzwang is common with only king and pawns left, where passing is unsound
+    uint64_t pieces = board.side_to_move
+        ? board.bitboards[WN] | board.bitboards[WB] | board.bitboards[WR] | board.bitboards[WQ]
+        : board.bitboards[BN] | board.bitboards[BB] | board.bitboards[BR] | board.bitboards[BQ];
+    return pieces != 0ULL;
+}
+
+// The quiet move that last refuted the opponent's previous move, if any
+Move Search::countermove_for(const Worker& worker) {
+    const UndoInfo* previous = worker.board.history;
+    if (!previous || previous->moved_piece == NO_PIECE) {
+        return Move();
+    }
+    return worker.heuristics.countermoves[previous->moved_piece][previous->move.to()];
+}
+
+void Search::update_quiet_stats(Worker& worker, const Move& move, int ply, int depth,
+                                const Move* tried_quiets, int tried_count) {
+    if (worker.killers[ply][0] != move) {
+        worker.killers[ply][1] = worker.killers[ply][0];
+        worker.killers[ply][0] = move;
+    }
+    
+    const Board& board = worker.board;
+    const UndoInfo* previous = board.history;
+    if (previous && previous->moved_piece != NO_PIECE) {
+        worker.heuristics.countermoves[previous->moved_piece][previous->move.to()] = move;
+    }
+    
+    // Reward the cutoff move and penalise the quiets that were searched before it in vain
+    int bonus = std::min(32 * depth * depth, 2000);
+    worker.heuristics.update_history(board, move, bonus);
+    for (int i = 0; i < tried_count; ++i) {
+        worker.heuristics.update_history(board, tried_quiets[i], -bonus);
+    }
+}
+
+// Mate scores are stored relative to the node, not the root, so they stay valid at any ply
+int Search::score_to_tt(int score, int ply) {
+    if (score >= MATE_BOUND) {
+        return score + ply;
+    }
+    if (score <= -MATE_BOUND) {
+        return score - ply;
+    }
+    return score;
+}
+
+int Search::score_from_tt(int score, int ply) {
+    if (score >= MATE_BOUND) {
+        return score - ply;
+    }
+    if (score <= -MATE_BOUND) {
+        return score + ply;
+    }
+    return score;
+}
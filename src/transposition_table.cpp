@@ -0,0 +1,101 @@
+#include "transposition_table.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t megabytes) : count(0), generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    count = std::max<size_t>(1, megabytes * 1024 * 1024 / sizeof(Bucket));
+    buckets.reset(new Bucket[count]);
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < count; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+uint64_t TranspositionTable::pack(Move move, int score, int depth, Bound bound, int generation) {
+    return static_cast<uint64_t>(move.data) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32) |
+           (static_cast<uint64_t>(bound) << 40) |
+           (static_cast<uint64_t>(generation) << 42);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& data) const {
+    const Bucket& bucket = bucket_for(key);
+    
+    for (const Entry& entry : bucket.entries) {
+        uint64_t entry_data = entry.data.load(std::memory_order_relaxed);
+        uint64_t entry_check = entry.check.load(std::memory_order_relaxed);
+        
+        if ((entry_check ^ entry_data) == key && ((entry_data >> 40) & 3) != BOUND_NONE) {
+            data.move.data = static_cast<uint16_t>(entry_data);
+            data.score = static_cast<int16_t>(entry_data >> 16);
+            data.depth = unpack_depth(entry_data);
+            data.bound = static_cast<Bound>((entry_data >> 40) & 3);
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound) {
+    // Check extensions can carry a last iteration past MAX_DEPTH
+    depth = std::min(depth, MAX_DEPTH);
+    Bucket& bucket = bucket_for(key);
+    Entry* replace = &bucket.entries[0];
+    int worst_value = 1 << 30;
+    
+    for (Entry& entry : bucket.entries) {
+        uint64_t entry_data = entry.data.load(std::memory_order_relaxed);
+        uint64_t entry_check = entry.check.load(std::memory_order_relaxed);
+        
+        if ((entry_check ^ entry_data) == key) {
+            // Same position: keep a deeper result unless the new one is exact
+            if (bound != BOUND_EXACT && depth < unpack_depth(entry_data) - 2 &&
+                unpack_generation(entry_data) == generation) {
+                return;
+            }
+            if (move == Move()) {
+                move.data = static_cast<uint16_t>(entry_data);
+            }
+            replace = &entry;
+            break;
+        }
+        
+        // Otherwise fill an empty slot or evict the shallowest entry, counting each search of age as 8 plies
+        int age = (generation - unpack_generation(entry_data)) & 0x3F;
+        int value = ((entry_data >> 40) & 3) == BOUND_NONE ? -(1 << 20) : unpack_depth(entry_data) - 8 * age;
+        if (value < worst_value) {
+            worst_value = value;
+            replace = &entry;
+        }
+    }
+    
+    uint64_t data = pack(move, score, depth, bound, generation);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    size_t samples = std::min<size_t>(count, 1000 / ENTRIES_PER_BUCKET);
+    int used = 0;
+    
+    for (size_t i = 0; i < samples; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            used += ((data >> 40) & 3) != BOUND_NONE && unpack_generation(data) == generation;
+        }
+    }
+    
+    return static_cast<int>(used * 1000 / (samples * ENTRIES_PER_BUCKET));
+}
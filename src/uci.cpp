@@ -0,0 +1,216 @@
+#include "uci.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+// Held back from the clock for GUI and process latency
+const int64_t MOVE_OVERHEAD_MS = 30;
+// Assumed number of moves left when the GUI does not say
+const int DEFAULT_MOVES_TO_GO = 30;
+
+UciEngine::UciEngine(std::istream& in, std::ostream& out)
+    : in(in), out(out), table(DEFAULT_HASH_MB), search(table), searching(false) {
+}
+
+UciEngine::~UciEngine() {
+    stop_search();
+}
+
+void UciEngine::loop() {
+    std::string line;
+    
+    while (std::getline(in, line)) {
+        std::istringstream command(line);
+        std::string token;
+        command >> token;
+        
+        if (token == "uci") {
+            handle_uci();
+        } else if (token == "isready") {
+            send("readyok");
+        } else if (token == "ucinewgame") {
+            stop_search();
+            table.clear();
+            board = Board();
+        } else if (token == "setoption") {
+            handle_setoption(command);
+        } else if (token == "position") {
+            handle_position(command);
+        } else if (token == "go") {
+            handle_go(command);
+        } else if (token == "stop") {
+            stop_search();
+        } else if (token == "quit") {
+            break;
+        }
+    }
+    
+    stop_search();
+}
+
+void UciEngine::handle_uci() {
+    send("id name QuanticChess");
+    send("id author QuanticChess developers");
+    send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) +
+         " min 1 max " + std::to_string(MAX_HASH_MB));
+    send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+    send("uciok");
+}
+
+// setoption name <id> value <x>
+void UciEngine::handle_setoption(std::istringstream& command) {
+    std::string token, name, value;
+    command >> token;
+    
+    while (command >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    command >> value;
+    
+    // Both options reallocate state the search thread is using
+    stop_search();
+    
+    if (name == "Hash") {
+        table.resize(static_cast<size_t>(std::clamp(std::atoi(value.c_str()), 1, MAX_HASH_MB)));
+    } else if (name == "Threads") {
+        search.set_threads(std::clamp(std::atoi(value.c_str()), 1, MAX_THREADS));
+    } else {
+        send("info string unknown option " + name);
+    }
+}
+
+// position [startpos | fen <fen>] [moves <move> ...]
+void UciEngine::handle_position(std::istringstream& command) {
+    std::string token, fen;
+    command >> token;
+    
+    if (token == "startpos") {
+        fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        command >> token;
+    } else if (token == "fen") {
+        while (command >> token && token != "moves") {
+            fen += (fen.empty() ? "" : " ") + token;
+        }
+    } else {
+        return;
+    }
+    
+    // The running search reads game_history through its root board
+    stop_search();
+    
+    FenError error = board.load_fen(fen);
+    if (error != FenError::NONE) {
+        send("info string invalid fen: " + std::string(Board::fen_error_message(error)));
+        return;
+    }
+    game_history.clear();
+    
+    while (command >> token) {
+        Move move = parse_move(token);
+        if (move == Move()) {
+            send("info string illegal move " + token);
+            return;
+        }
+        
+        game_history.emplace_back();
+        board.make_move(move, game_history.back());
+    }
+}
+
+// go [depth D] [nodes N] [movetime T] [wtime T] [btime T] [winc T] [binc T] [movestogo M] [infinite]
+void UciEngine::handle_go(std::istringstream& command) {
+    stop_search();
+    
+    SearchLimits limits;
+    int64_t time_left = 0, increment = 0;
+    int moves_to_go = DEFAULT_MOVES_TO_GO;
+    std::string token;
+    
+    while (command >> token) {
+        int64_t value = 0;
+        if (token == "infinite") {
+            limits.infinite = true;
+            continue;
+        }
+        command >> value;
+        
+        if (token == "depth") {
+            limits.depth = static_cast<int>(value);
+        } else if (token == "nodes") {
+            limits.nodes = static_cast<uint64_t>(value);
+        } else if (token == "movetime") {
+            limits.time_ms = value;
+        } else if (token == "movestogo") {
+            moves_to_go = std::max<int64_t>(1, value);
+        } else if (token == (board.side_to_move ? "wtime" : "btime")) {
+            time_left = value;
+        } else if (token == (board.side_to_move ? "winc" : "binc")) {
+            increment = value;
+        }
+    }
+    
+    // An even share of the remaining clock plus most of the increment, never the whole clock
+    if (time_left > 0 && limits.time_ms == 0) {
+        int64_t budget = time_left / moves_to_go + increment * 3 / 4;
+        limits.time_ms = std::max<int64_t>(1, std::min(budget, time_left - MOVE_OVERHEAD_MS));
+    }
+    
+    searching.store(true);
+    search_thread = std::thread([this, limits, position = board]() {
+        Move best_move = search.think(position, limits, [this](const SearchReport& report) {
+            std::string line = "info depth " + std::to_string(report.depth) +
+                               " score " + format_score(report.score) +
+                               " nodes " + std::to_string(report.nodes) +
+                               " nps " + std::to_string(report.nps) +
+                               " hashfull " + std::to_string(report.hashfull) +
+                               " time " + std::to_string(report.time_ms) + " pv";
+            for (const Move& move : report.pv) {
+                line += " " + Board::move_to_string(move);
+            }
+            send(line);
+        });
+        
+        send("bestmove " + (best_move == Move() ? std::string("0000") : Board::move_to_string(best_move)));
+        searching.store(false);
+    });
+}
+
+void UciEngine::stop_search() {
+    // think() clears the stop flag when it starts, so a stop that arrives before the
+    // thread gets there would be lost; keep asking until the search has really ended
+    while (searching.load()) {
+        search.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (search_thread.joinable()) {
+        search_thread.join();
+    }
+}
+
+Move UciEngine::parse_move(const std::string& text) {
+    MoveList move_list;
+    board.generate_moves(move_list);
+    
+    for (const Move& move : move_list) {
+        if (Board::move_to_string(move) == text) {
+            return move;
+        }
+    }
+    return Move();
+}
+
+void UciEngine::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(output_mutex);
+    out << line << std::endl;
+}
+
+// Mate scores become "mate N" in moves, negative when the engine is being mated
+std::string UciEngine::format_score(int score) {
+    if (score >= Search::MATE_BOUND) {
+        return "mate " + std::to_string((Search::MATE_SCORE - score + 1) / 2);
+    }
+    if (score <= -Search::MATE_BOUND) {
+        return "mate " + std::to_string(-(Search::MATE_SCORE + score) / 2);
+    }
+    return "cp " + std::to_string(score);
+}
@@ -0,0 +1,176 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bitboard.h"
+#include "geometric_evaluator.h"
+#include "position_batch.h"
+#include "search.h"
+#include "transposition_table.h"
+
+namespace {
+
+// Middlegame and endgame positions with enough tactics to keep every thread busy
+const char* bench_positions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+struct BenchResult {
+    uint64_t nodes;
+    double seconds;
+    std::vector<uint64_t> position_nodes;
+};
+
+// Time to depth over the whole position set, starting every position from an empty table
+BenchResult run_bench(int threads, int depth, size_t hash_megabytes) {
+    TranspositionTable table(hash_megabytes);
+    Search search(table, threads);
+    SearchLimits limits;
+    limits.depth = depth;
+
+    BenchResult result = {0, 0.0, {}};
+    for (const char* fen : bench_positions) {
+        Board board = Board::from_fen(fen).value();
+        table.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        search.think(board, limits);
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.nodes += search.total_nodes();
+        result.position_nodes.push_back(search.total_nodes());
+    }
+
+    return result;
+}
+
+// evaluate_batch must reproduce evaluate_position bit for bit. Checked on the bench positions and
+// on every position of seeded random playouts from them; returns the number of mismatches.
+size_t verify_batch_evaluation() {
+    const int playouts_per_position = 200;
+    const int playout_length = 120;
+
+    size_t position_count = sizeof(bench_positions) / sizeof(bench_positions[0]);
+    std::vector<UndoInfo> undo(position_count * playouts_per_position * playout_length);
+    std::vector<Board> boards;
+    std::mt19937 rng(12345);
+
+    size_t record = 0;
+    for (const char* fen : bench_positions) {
+        Board root = Board::from_fen(fen).value();
+        boards.push_back(root);
+
+        for (int playout = 0; playout < playouts_per_position; ++playout) {
+            Board board = root;
+            for (int ply = 0; ply < playout_length; ++ply, ++record) {
+                MoveList moves;
+                board.generate_moves(moves);
+                if (moves.empty()) {
+                    break;
+                }
+                board.make_move(moves[rng() % moves.size()], undo[record]);
+                boards.push_back(board);
+            }
+        }
+    }
+
+    PositionBatch batch(boards.data(), boards.size());
+    std::vector<Multivector2D> batched(boards.size());
+    GeometricEvaluator::evaluate_batch(batch, batched.data());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < boards.size(); ++i) {
+        Multivector2D expected = GeometricEvaluator::evaluate_position(boards[i]);
+        if (std::memcmp(&expected, &batched[i], sizeof(Multivector2D)) != 0) {
+            if (mismatches++ < 10) {
+                std::cout << "mismatch: " << boards[i].to_fen_string() << std::endl;
+            }
+        }
+    }
+
+    std::cout << "verified evaluate_batch on " << boards.size() << " positions: "
+              << mismatches << " mismatches" << std::endl;
+    return mismatches;
+}
+
+void print_usage() {
+    std::cout << "Usage:" << std::endl
+              << "  bench [options]    nodes to depth per bench position, then time to depth" << std::endl
+              << "                     over the whole set from 1 thread up to N" << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --depth D      search depth per position (default: 8)" << std::endl
+              << "  --threads N    highest thread count to measure (default: all cores)" << std::endl
+              << "  --hash MB      transposition table size (default: 64)" << std::endl
+              << "  --verify       check evaluate_batch against evaluate_position, then exit" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    size_t hash_megabytes = 64;
+    int depth = 8;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--threads" && i + 1 < argc) {
+            max_threads = std::atoi(argv[++i]);
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hash_megabytes = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (arg == "--depth" && i + 1 < argc) {
+            depth = std::atoi(argv[++i]);
+        } else if (arg == "--verify") {
+            return verify_batch_evaluation() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else {
+            print_usage();
+            return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    // A single thread searches deterministically, so its node counts measure move ordering
+    BenchResult single = run_bench(1, depth, hash_megabytes);
+    std::cout << std::setw(8) << "position" << std::setw(14) << "nodes" << std::endl;
+    for (size_t i = 0; i < single.position_nodes.size(); ++i) {
+        std::cout << std::setw(8) << i + 1 << std::setw(14) << single.position_nodes[i] << std::endl;
+    }
+    std::cout << std::setw(8) << "total" << std::setw(14) << single.nodes << std::endl << std::endl;
+
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "nodes" << std::setw(10) << "time s"
+              << std::setw(12) << "nps" << std::setw(10) << "speedup" << std::endl;
+
+    double baseline = 0.0;
+    for (int threads : thread_counts) {
+        BenchResult result = threads == 1 ? single : run_bench(threads, depth, hash_megabytes);
+        if (threads == 1) {
+            baseline = result.seconds;
+        }
+
+        std::cout << std::setw(8) << threads << std::setw(14) << result.nodes
+                  << std::setw(10) << std::fixed << std::setprecision(3) << result.seconds
+                  << std::setw(12) << static_cast<uint64_t>(result.nodes / result.seconds)
+                  << std::setw(9) << std::setprecision(2) << baseline / result.seconds << "x" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
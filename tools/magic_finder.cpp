@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "magic_bitboards.h"
+
+namespace {
+
+struct MagicJob {
+    int square;
+    bool is_rook;
+    uint64_t magic;
+    int bits;
+};
+
+// Candidate checker with an epoch-stamped scratch table: a slot is live only if its
+// stamp matches the current candidate, so nothing is cleared between attempts
+class MagicSearcher {
+public:
+    MagicSearcher(int square, bool is_rook, uint64_t seed)
+        : mask(MagicBitboards::generate_blocker_mask(square, is_rook)), rng(seed), epoch(0) {
+        uint64_t blocker = 0;
+        do {
+            occupancies.push_back(blocker);
+            attacks.push_back(MagicBitboards::generate_attack_mask(square, blocker, is_rook));
+            blocker = (blocker - mask) & mask;
+        } while (blocker);
+        
+        stamps.assign(occupancies.size(), 0);
+        slots.assign(occupancies.size(), 0);
+    }
+    
+    int mask_bits() const { return __builtin_popcountll(mask); }
+    
+    // Constructive collisions (same attack set) are allowed, which is what lets bits < mask_bits
+    bool try_magic(uint64_t magic, int bits) {
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+        int shift = 64 - bits;
+        
+        for (size_t i = 0; i < occupancies.size(); i++) {
+            uint64_t index = (occupancies[i] * magic) >> shift;
+            if (stamps[index] != epoch) {
+                stamps[index] = epoch;
+                slots[index] = attacks[i];
+            } else if (slots[index] != attacks[i]) {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    uint64_t search(int bits, std::chrono::steady_clock::time_point deadline) {
+        for (uint64_t attempt = 0;; attempt++) {
+            if ((attempt & 0xFFF) == 0 && std::chrono::steady_clock::now() > deadline) {
+                return 0;
+            }
+            
+            uint64_t magic = rng() & rng() & rng();
+            if (__builtin_popcountll((mask * magic) & 0xFF00000000000000ULL) < 6) {
+                continue;
+            }
+            if (try_magic(magic, bits)) {
+                return magic;
+            }
+        }
+    }
+    
+private:
+    uint64_t mask;
+    std::mt19937_64 rng;
+    uint32_t epoch;
+    std::vector<uint64_t> occupancies;
+    std::vector<uint64_t> attacks;
+    std::vector<uint32_t> stamps;
+    std::vector<uint64_t> slots;
+};
+
+void solve(MagicJob& job, uint64_t seed, double seconds_per_bit) {
+    MagicSearcher searcher(job.square, job.is_rook, seed);
+    auto forever = std::chrono::steady_clock::time_point::max();
+    
+    // A full-width magic always exists; then keep shaving index bits while time allows
+    job.bits = searcher.mask_bits();
+    job.magic = searcher.search(job.bits, forever);
+    
+    while (seconds_per_bit > 0.0) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(seconds_per_bit));
+        uint64_t magic = searcher.search(job.bits - 1, deadline);
+        if (!magic) {
+            break;
+        }
+        job.magic = magic;
+        job.bits--;
+    }
+}
+
+size_t table_size(const std::vector<MagicJob>& jobs, bool is_rook) {
+    size_t size = 0;
+    for (const MagicJob& job : jobs) {
+        if (job.is_rook == is_rook) {
+            size += 1ULL << job.bits;
+        }
+    }
+    return size;
+}
+
+void write_array(std::ostream& out, const char* type, const char* name,
+                 const std::vector<MagicJob>& jobs, bool is_rook, bool shifts) {
+    out << "inline constexpr " << type << " " << name << "[64] = {";
+    int column = 0;
+    for (const MagicJob& job : jobs) {
+        if (job.is_rook != is_rook) {
+            continue;
+        }
+        out << (column % (shifts ? 16 : 4) == 0 ? "\n    " : " ");
+        if (shifts) {
+            out << std::dec << (64 - job.bits) << ",";
+        } else {
+            out << "0x" << std::hex << job.magic << std::dec << "ULL,";
+        }
+        column++;
+    }
+    out << "\n};\n\n";
+}
+
+std::string generate_header(const std::vector<MagicJob>& jobs) {
+    std::ostringstream out;
+    out << "#pragma once\n\n"
+        << "// Generated by tools/magic_finder.cpp - do not edit by hand.\n"
+        << "// Regenerate with: magic_finder --output include/magic_numbers.h\n\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n\n";
+    
+    write_array(out, "uint64_t", "ROOK_MAGICS", jobs, true, false);
+    write_array(out, "int", "ROOK_SHIFTS", jobs, true, true);
+    write_array(out, "uint64_t", "BISHOP_MAGICS", jobs, false, false);
+    write_array(out, "int", "BISHOP_SHIFTS", jobs, false, true);
+    
+    out << "inline constexpr size_t ROOK_MAGIC_TABLE_SIZE = " << table_size(jobs, true) << ";\n"
+        << "inline constexpr size_t BISHOP_MAGIC_TABLE_SIZE = " << table_size(jobs, false) << ";\n";
+    
+    return out.str();
+}
+
+void print_usage() {
+    std::cout << "Usage: magic_finder [options]" << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --output FILE       header to write (default: print to stdout)" << std::endl
+              << "  --threads N         search squares in parallel (default: all cores)" << std::endl
+              << "  --seconds S         time spent trying to drop each extra index bit (default: 2)" << std::endl
+              << "  --seed N            base seed for the candidate generator" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string output;
+    int thread_count = static_cast<int>(std::thread::hardware_concurrency());
+    double seconds_per_bit = 2.0;
+    uint64_t seed = 0x5EED0F4A61C5ULL;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            thread_count = std::atoi(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds_per_bit = std::atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            print_usage();
+            return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    
+    std::vector<MagicJob> jobs;
+    for (int is_rook = 1; is_rook >= 0; is_rook--) {
+        for (int square = 0; square < 64; square++) {
+            jobs.push_back(MagicJob{square, is_rook == 1, 0, 0});
+        }
+    }
+    
+    std::atomic<size_t> next_job(0);
+    auto worker = [&]() {
+        size_t index;
+        while ((index = next_job.fetch_add(1)) < jobs.size()) {
+            solve(jobs[index], seed ^ (index * 0x9E3779B97F4A7C15ULL), seconds_per_bit);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int i = 1; i < thread_count; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    
+    std::cerr << "Rook table: " << table_size(jobs, true) << " entries (plain: 102400)" << std::endl
+              << "Bishop table: " << table_size(jobs, false) << " entries (plain: 5248)" << std::endl;
+    
+    std::string header = generate_header(jobs);
+    if (output.empty()) {
+        std::cout << header;
+        return EXIT_SUCCESS;
+    }
+    
+    std::ofstream file(output);
+    if (!file) {
+        std::cerr << "Cannot write " << output << std::endl;
+        return EXIT_FAILURE;
+    }
+    file << header;
+    
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,278 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bitboard.h"
+
+namespace {
+
+struct ReferencePosition {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+// Standard validation positions (chessprogramming.org "Perft Results")
+const ReferencePosition reference_positions[] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324ULL},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690ULL},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 7, 178633661ULL},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL},
+    {"position4-mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 5, 15833292ULL},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89941194ULL},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 5, 164075551ULL},
+};
+
+// Shared between all root threads; entries are verified by XOR so torn writes are simply misses
+class PerftHashTable {
+public:
+    explicit PerftHashTable(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) {
+            count *= 2;
+        }
+        entries.reset(new Entry[count]);
+        mask = count - 1;
+        for (size_t i = 0; i < count; i++) {
+            entries[i].check.store(0, std::memory_order_relaxed);
+            entries[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const {
+        const Entry& entry = entries[key & mask];
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        
+        if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth) {
+            return false;
+        }
+        
+        nodes = data >> 8;
+        return true;
+    }
+    
+    void store(uint64_t key, int depth, uint64_t nodes) {
+        Entry& entry = entries[key & mask];
+        uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+        entry.check.store(key ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+    
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+    
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+};
+
+uint64_t perft(Board& board, int depth, PerftHashTable* table) {
+    uint64_t key = 0;
+    uint64_t nodes = 0;
+    
+    if (table && depth > 1) {
+        key = board.hash_key;
+        if (table->probe(key, depth, nodes)) {
+            return nodes;
+        }
+    }
+    
+    MoveList moves;
+    board.generate_moves(moves);
+    
+    // Bulk counting: the legal generator already knows the leaf count
+    if (depth == 1) {
+        return moves.size();
+    }
+    
+    UndoInfo undo;
+    for (const Move& move : moves) {
+        board.make_move(move, undo);
+        nodes += perft(board, depth - 1, table);
+        board.unmake_move();
+    }
+    
+    if (table) {
+        table->store(key, depth, nodes);
+    }
+    
+    return nodes;
+}
+
+struct PerftResult {
+    uint64_t nodes;
+    double seconds;
+};
+
+PerftResult run_perft(const Board& root, int depth, int thread_count, PerftHashTable* table, bool divide) {
+    auto start = std::chrono::steady_clock::now();
+    
+    Board board = root;
+    MoveList moves;
+    board.generate_moves(moves);
+    
+    std::vector<uint64_t> move_nodes(moves.size(), 0);
+    std::atomic<size_t> next_move(0);
+    
+    // Root moves are handed out one at a time so a single heavy subtree cannot stall the others
+    auto worker = [&]() {
+        Board local = root;
+        UndoInfo undo;
+        size_t index;
+        while ((index = next_move.fetch_add(1)) < moves.size()) {
+            local.make_move(moves[index], undo);
+            move_nodes[index] = depth > 1 ? perft(local, depth - 1, table) : 1;
+            local.unmake_move();
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int i = 1; i < thread_count; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    
+    uint64_t total = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (divide) {
+            std::cout << Board::move_to_string(moves[i]) << ": " << move_nodes[i] << std::endl;
+        }
+        total += move_nodes[i];
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return PerftResult{total, seconds};
+}
+
+uint64_t nodes_per_second(const PerftResult& result) {
+    return result.seconds > 0.0 ? static_cast<uint64_t>(result.nodes / result.seconds) : 0;
+}
+
+int run_reference_suite(int thread_count, size_t hash_megabytes) {
+    bool all_passed = true;
+    uint64_t total_nodes = 0;
+    double total_seconds = 0.0;
+    
+    std::cout << "Running perft reference suite with " << thread_count << " thread(s)";
+    if (hash_megabytes) {
+        std::cout << " and a " << hash_megabytes << " MB hash";
+    }
+    std::cout << std::endl << std::endl;
+    
+    for (const ReferencePosition& position : reference_positions) {
+        Board board;
+        board.load_fen(position.fen);
+        
+        std::unique_ptr<PerftHashTable> table;
+        if (hash_megabytes) {
+            table.reset(new PerftHashTable(hash_megabytes));
+        }
+        
+        PerftResult result = run_perft(board, position.depth, thread_count, table.get(), false);
+        bool passed = result.nodes == position.nodes;
+        all_passed = all_passed && passed;
+        total_nodes += result.nodes;
+        total_seconds += result.seconds;
+        
+        std::cout << (passed ? "[ OK ] " : "[FAIL] ") << std::left << std::setw(20) << position.name
+                  << " depth " << position.depth << "  " << std::right << std::setw(11) << result.nodes;
+        if (!passed) {
+            std::cout << " (expected " << position.nodes << ")";
+        }
+        std::cout << "  " << std::fixed << std::setprecision(3) << result.seconds << " s  "
+                  << nodes_per_second(result) << " nps" << std::endl;
+    }
+    
+    PerftResult total{total_nodes, total_seconds};
+    std::cout << std::endl << "Total: " << total_nodes << " nodes in " << std::fixed << std::setprecision(3)
+              << total_seconds << " s (" << nodes_per_second(total) << " nps)" << std::endl;
+    
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void print_usage() {
+    std::cout << "Usage:" << std::endl
+              << "  perft [options]                  run the reference suite" << std::endl
+              << "  perft [options] <depth> [fen]    divide from fen (default: start position)" << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --threads N    split root moves across N threads (default: all cores)" << std::endl
+              << "  --hash MB      share a perft hash table of MB megabytes (default: off)" << std::endl
+              << "  --no-divide    only print the total" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int thread_count = static_cast<int>(std::thread::hardware_concurrency());
+    size_t hash_megabytes = 0;
+    bool divide = true;
+    int depth = -1;
+    std::string fen;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "--threads" && i + 1 < argc) {
+            thread_count = std::atoi(argv[++i]);
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hash_megabytes = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (arg == "--no-divide") {
+            divide = false;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return EXIT_SUCCESS;
+        } else if (depth < 0) {
+            depth = std::atoi(arg.c_str());
+        } else {
+            // FEN fields may arrive unquoted as separate arguments
+            fen += (fen.empty() ? "" : " ") + arg;
+        }
+    }
+    
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    
+    if (depth == 0) {
+        depth = 1;
+    }
+    
+    if (depth < 0) {
+        return run_reference_suite(thread_count, hash_megabytes);
+    }
+    
+    Board board;
+    if (!fen.empty()) {
+        FenError error = board.load_fen(fen);
+        if (error != FenError::NONE) {
+            std::cerr << "Invalid FEN: " << Board::fen_error_message(error) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    
+    std::unique_ptr<PerftHashTable> table;
+    if (hash_megabytes) {
+        table.reset(new PerftHashTable(hash_megabytes));
+    }
+    
+    PerftResult result = run_perft(board, depth, thread_count, table.get(), divide);
+    
+    std::cout << std::endl << "Nodes: " << result.nodes << std::endl
+              << "Time: " << std::fixed << std::setprecision(3) << result.seconds << " s" << std::endl
+              << "NPS: " << nodes_per_second(result) << std::endl;
+    
+    return EXIT_SUCCESS;
+}